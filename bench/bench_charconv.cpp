@@ -0,0 +1,92 @@
+/**
+ * -- troll --
+ * 
+ * Copyright (c) 2023 dearoneesama
+ * 
+ * This software is licensed under MIT License.
+ */
+
+// built twice, with and without TROLL_STD_CHARCONV, so that the two number backends can be
+// compared on the same machine. Run both executables, or the `bench` target, and compare the
+// lines with the same name.
+
+#include <chrono>
+#include <cstdio>
+
+#include <troll_util/format_scan.hpp>
+
+#if defined(TROLL_STD_CHARCONV)
+static constexpr const char *backend = "std::to_chars/std::from_chars";
+#else
+static constexpr const char *backend = "etl";
+#endif
+
+static constexpr size_t rounds = 7;
+static constexpr size_t iterations = 200000;
+
+// keeps the compiler from dropping the work whose result is not otherwise used.
+template<class T>
+static void keep(const T &v) {
+  asm volatile("" : : "g"(&v) : "memory");
+}
+
+// prints the fastest of the rounds, per call of the body.
+template<class F>
+static void run(const char *name, F &&body) {
+  double best = 0;
+  for (size_t r = 0; r < rounds; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+      body(i);
+    }
+    std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+    double ns = took.count() / iterations;
+    best = r == 0 || ns < best ? ns : best;
+  }
+  std::printf("%-24s %8.1f ns\n", name, best);
+}
+
+int main() {
+  std::printf("backend: %s\n", backend);
+
+  static const char *const int_texts[] = {"0", "7", "-42", "1234", "65535", "-2147483648", "4000000000", "18446744073709551615"};
+  static const char *const float_texts[] = {"0", "1.5", "-0.25", "3.14159", "1e10", "-2.5e-3", "123456.789", "6.02e23"};
+  static const int ints[] = {0, 7, -42, 1234, 65535, -2147483647 - 1, 1000000, 99};
+  static const double doubles[] = {0.0, 1.5, -0.25, 3.14159, 1e6, -2.5e-3, 123456.789, 42.0};
+
+  run("format int", [&](size_t i) {
+    char buf[32];
+    keep(troll::snformat(buf, "{}", ints[i % 8]));
+    keep(buf);
+  });
+  run("format 3 ints", [&](size_t i) {
+    char buf[64];
+    keep(troll::snformat(buf, "x={} y={} z={}", ints[i % 8], ints[(i + 3) % 8], uint64_t(i) * 2654435761u));
+    keep(buf);
+  });
+  run("format double", [&](size_t i) {
+    char buf[48];
+    keep(troll::snformat(buf, "{}", doubles[i % 8]));
+    keep(buf);
+  });
+  run("scan int", [&](size_t i) {
+    long long v = 0;
+    keep(troll::sscan(int_texts[i % 6], "{}", v));
+    keep(v);
+  });
+  run("scan uint64", [&](size_t i) {
+    unsigned long long v = 0;
+    keep(troll::sscan(int_texts[i % 8] + (int_texts[i % 8][0] == '-'), "{}", v));
+    keep(v);
+  });
+  run("scan 3 ints", [&](size_t i) {
+    int a = 0, b = 0, c = 0;
+    keep(troll::sscan("set 17 -4 2048", "set {} {} {}", a, b, c));
+    keep(a + b + c + int(i));
+  });
+  run("scan long double", [&](size_t i) {
+    long double v = 0;
+    keep(troll::sscan(float_texts[i % 8], "{}", v));
+    keep(v);
+  });
+}
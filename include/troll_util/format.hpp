@@ -11,6 +11,21 @@
 #include <etl/to_string.h>
 #include <etl/queue.h>
 #include <etl/optional.h>
+#include <iterator>
+#include "instrument.hpp"
+#include "utils.hpp"
+
+// Define TROLL_STD_CHARCONV on hosted builds to convert numbers with std::to_chars and
+// std::from_chars instead of etl, and to accept std::string and std::string_view as arguments
+// and captures. Freestanding builds keep using etl.
+#if defined(TROLL_STD_CHARCONV)
+#if !__STDC_HOSTED__
+#error "TROLL_STD_CHARCONV requires a hosted build"
+#endif
+#include <charconv>
+#include <string>
+#include <string_view>
+#endif
 
 // screen-printing utilities
 #define LEN_LITERAL(x) (sizeof(x) / sizeof(x[0]) - 1)
@@ -28,12 +43,69 @@ namespace troll {
     return dest;
   }
 
+  // "00", "01", ..., "99", for writing two digits at a time.
+  static constexpr char digit_pairs_[] =
+    "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+    "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+  // writes exactly width digits of value, with leading zeros, and returns the end.
+  constexpr inline char *write_fixed_digits_(char *dest, uint64_t value, unsigned width) noexcept {
+    char *end = dest + width, *p = end;
+    for (; width >= 2; width -= 2) {
+      p -= 2;
+      p[0] = digit_pairs_[value % 100 * 2];
+      p[1] = digit_pairs_[value % 100 * 2 + 1];
+      value /= 100;
+    }
+    if (width) {
+      *--p = char('0' + value % 10);
+    }
+    return end;
+  }
+
+  // the number of decimal digits of value, which is 1 for zero.
+  constexpr inline unsigned count_digits_(uint64_t value) noexcept {
+    unsigned n = 1;
+    for (; value >= 100; value /= 100) n += 2;
+    return n + (value >= 10);
+  }
+
+  constexpr inline uint64_t pow10_(unsigned n) noexcept {
+    uint64_t r = 1;
+    while (n--) r *= 10;
+    return r;
+  }
+
+  // writes value without leading zeros and returns the end.
+  constexpr inline char *write_digits_(char *dest, uint64_t value) noexcept {
+    return write_fixed_digits_(dest, value, count_digits_(value));
+  }
+
   template<class T>
   struct is_etl_string : std::false_type {};
 
   template<size_t N>
   struct is_etl_string<::etl::string<N>> : std::true_type {};
 
+  template<class T>
+  struct is_std_string : std::false_type {};
+
+#if defined(TROLL_STD_CHARCONV)
+  template<>
+  struct is_std_string<std::string> : std::true_type {};
+
+  template<>
+  struct is_std_string<std::string_view> : std::true_type {};
+
+  // whether std::to_chars and std::from_chars take the type.
+  template<class T>
+  static constexpr bool is_charconv_type_v = (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+#if defined(__cpp_lib_to_chars)
+    || std::is_floating_point_v<T>
+#endif
+    ;
+#endif  // TROLL_STD_CHARCONV
+
   struct unsupported_to_string_type {};
 
   template<class T>
@@ -42,6 +114,83 @@ namespace troll {
     unsupported_to_string_type operator()(TT, ::etl::istring &) const;
   };
 
+  // How the digits that do not fit into the precision are dropped.
+  enum class fixed_rounding {
+    // Round half away from zero.
+    nearest,
+    // Round toward zero.
+    truncate,
+  };
+
+  constexpr inline unsigned fixed_default_precision_(uint64_t scale) noexcept {
+    return scale > 1 ? count_digits_(scale - 1) : 0;
+  }
+
+  /**
+   * A scaled integer, `value / Scale`, that is formatted by a `{}` placeholder with Precision
+   * digits after the dot (none if zero) using integer arithmetic only. For example,
+   * `fixed<1000>{1234}` is formatted as `1.234` and `fixed<1024, 2>{-1536}` as `-1.50`.
+   * It can also be captured by `sscan`.
+   */
+  template<uint64_t Scale, unsigned Precision = fixed_default_precision_(Scale), fixed_rounding Rounding = fixed_rounding::nearest>
+  struct fixed {
+    static_assert(Scale > 0, "the scale must be positive");
+    static_assert(Precision <= 19 && Scale <= UINT64_MAX / 2 / pow10_(Precision), "the fraction would overflow");
+
+    int64_t value;
+
+    static constexpr uint64_t scale = Scale;
+    static constexpr unsigned precision = Precision;
+    static constexpr fixed_rounding rounding = Rounding;
+    // the longest text, excluding the nul.
+    static constexpr size_t max_size = 1 + 19 + (Precision ? Precision + 1 : 0);
+  };
+
+  /**
+   * A scaled integer with Digits decimal places, `value / 10^Digits`.
+   */
+  template<unsigned Digits, unsigned Precision = Digits, fixed_rounding Rounding = fixed_rounding::nearest>
+  using decimal = fixed<pow10_(Digits), Precision, Rounding>;
+
+  template<class T>
+  struct is_fixed : std::false_type {};
+
+  template<uint64_t Scale, unsigned Precision, fixed_rounding Rounding>
+  struct is_fixed<fixed<Scale, Precision, Rounding>> : std::true_type {};
+
+  /**
+   * Writes the number and returns the end. The destination needs `fixed::max_size` characters
+   * at most; the nul is not written.
+   */
+  template<uint64_t Scale, unsigned Precision, fixed_rounding Rounding>
+  constexpr inline char *write_fixed(char *dest, fixed<Scale, Precision, Rounding> f) noexcept {
+    uint64_t mag = f.value < 0 ? 0 - uint64_t(f.value) : uint64_t(f.value);
+    uint64_t whole = mag / Scale, num = mag % Scale * pow10_(Precision);
+    uint64_t frac = num / Scale;
+    if (Rounding == fixed_rounding::nearest && num % Scale * 2 >= Scale && ++frac == pow10_(Precision)) {
+      frac = 0;
+      ++whole;
+    }
+    // no sign for what is rounded to zero
+    if (f.value < 0 && (whole || frac)) {
+      *dest++ = '-';
+    }
+    dest = write_digits_(dest, whole);
+    if constexpr (Precision > 0) {
+      *dest++ = '.';
+      dest = write_fixed_digits_(dest, frac, Precision);
+    }
+    return dest;
+  }
+
+  template<uint64_t Scale, unsigned Precision, fixed_rounding Rounding>
+  struct to_stringer<fixed<Scale, Precision, Rounding>> {
+    void operator()(const fixed<Scale, Precision, Rounding> &f, ::etl::istring &s) const {
+      char buf[fixed<Scale, Precision, Rounding>::max_size];
+      s.append(buf, size_t(write_fixed(buf, f) - buf));
+    }
+  };
+
   constexpr inline char *snformat_impl(char *dest, size_t destlen, const char *format) {
     for (size_t i = destlen - 1; *format && i--;) {
       *dest++ = *format++;
@@ -50,6 +199,123 @@ namespace troll {
     return dest;
   }
 
+  template<class T, class = void>
+  struct is_format_range : std::false_type {};
+
+  // anything with begin and end, except for strings
+  template<class T>
+  struct is_format_range<T, std::void_t<decltype(std::begin(std::declval<const T &>())), decltype(std::end(std::declval<const T &>()))>>
+    : std::bool_constant<!std::is_same_v<std::decay_t<decltype(*std::begin(std::declval<const T &>()))>, char>> {};
+
+  /**
+   * The elements of a range with a separator between them, to be formatted by a `{}`
+   * placeholder. Made by `join`.
+   */
+  template<class It>
+  struct format_join {
+    It first, last;
+    const char *sep;
+  };
+
+  template<class T>
+  struct is_format_join : std::false_type {};
+
+  template<class It>
+  struct is_format_join<format_join<It>> : std::true_type {};
+
+  /**
+   * Formats every element of the range with sep between them when it is passed to a `{}`
+   * placeholder. Nothing is copied; the range must outlive the call.
+   */
+  template<class Range>
+  constexpr inline auto join(const Range &range, const char *sep) noexcept {
+    return format_join<decltype(std::begin(range))>{std::begin(range), std::end(range), sep};
+  }
+
+  /**
+   * Overload that takes a pair of iterators.
+   */
+  template<class It>
+  constexpr inline format_join<It> join(It first, It last, const char *sep) noexcept {
+    return {first, last, sep};
+  }
+
+  template<class T>
+#if (defined(__GNUC__) && !defined(__clang__))
+  constexpr
+#endif  // if compiler is gcc
+  inline char *snformat_value_(char *dest, size_t destlen, const T &a0);
+
+  // writes the elements and separators one after another, until the buffer is full.
+  template<class It>
+#if (defined(__GNUC__) && !defined(__clang__))
+  constexpr
+#endif  // if compiler is gcc
+  inline char *snformat_range_(char *dest, size_t destlen, It first, It last, const char *sep) {
+    char *end = dest;
+    *end = '\0';
+    for (bool head = true; first != last; ++first, head = false) {
+      if (!head) {
+        end = snformat_impl(end, destlen - (end - dest), sep);
+      }
+      if (destlen - (end - dest) < 2) {
+        break;
+      }
+      end = snformat_value_(end, destlen - (end - dest), *first);
+    }
+    return end;
+  }
+
+  // writes one value and the nul, and returns the end.
+  template<class T>
+#if (defined(__GNUC__) && !defined(__clang__))
+  constexpr
+#endif  // if compiler is gcc
+  inline char *snformat_value_(char *dest, size_t destlen, const T &a0) {
+    using Decay = std::decay_t<T>;
+    ::etl::string_ext s{dest, destlen};
+    if constexpr (!std::is_same_v<decltype(to_stringer<Decay>{}(a0, s)), unsupported_to_string_type>) {
+      to_stringer<Decay>{}(a0, s);
+    } else if constexpr (is_format_join<Decay>::value) {
+      return snformat_range_(dest, destlen, a0.first, a0.last, a0.sep);
+    } else if constexpr (is_format_range<std::remove_cv_t<T>>::value) {
+      // vectors, arrays, ...
+      return snformat_range_(dest, destlen, std::begin(a0), std::end(a0), ", ");
+    } else if constexpr (std::is_pointer_v<Decay> && std::is_same_v<std::remove_const_t<std::remove_pointer_t<Decay>>, char>) {
+      // const char * <- to_string will print numbers instead
+      s.assign(a0);
+    } else if constexpr (std::is_same_v<Decay, char>) {
+      // print char instead of number
+      s.assign(1, a0);
+    } else if constexpr (is_etl_string<Decay>::value) {
+      // etl::to_string does not support etl::string arg
+      s.assign(a0);
+#if defined(TROLL_STD_CHARCONV)
+    } else if constexpr (is_std_string<Decay>::value) {
+      // std::string, std::string_view
+      s.assign(a0.data(), a0.size());
+    } else if constexpr (is_charconv_type_v<Decay>) {
+      // same text as etl, but numbers that do not fit keep their leading digits
+      char buf[64];
+      std::to_chars_result r;
+      if constexpr (std::is_floating_point_v<Decay>) {
+        r = std::to_chars(buf, buf + sizeof(buf), a0, std::chars_format::fixed, 6);
+      } else {
+        r = std::to_chars(buf, buf + sizeof(buf), a0);
+      }
+      if (r.ec == std::errc()) {
+        s.assign(buf, size_t(r.ptr - buf));
+      } else {
+        // huge floats
+        ::etl::to_string(a0, s);
+      }
+#endif  // TROLL_STD_CHARCONV
+    } else {
+      ::etl::to_string(a0, s);
+    }
+    return dest + s.length();
+  }
+
   template<class Arg0, class ...Args>
 #if (defined(__GNUC__) && !defined(__clang__))
   constexpr
@@ -58,24 +324,9 @@ namespace troll {
     for (size_t i = destlen - 1; *format && i;) {
       if (*format == '{' && *(format + 1) == '}') {
         size_t real_len = i + 1;
-        ::etl::string_ext s{dest, real_len};
-        using Decay = std::decay_t<Arg0>;
-        if constexpr (!std::is_same_v<decltype(to_stringer<Decay>{}(a0, s)), unsupported_to_string_type>) {
-          to_stringer<Decay>{}(a0, s);
-        } else if constexpr (std::is_pointer_v<Decay> && std::is_same_v<std::remove_const_t<std::remove_pointer_t<Decay>>, char>) {
-          // const char * <- to_string will print numbers instead
-          s.assign(a0);
-        } else if constexpr (std::is_same_v<Decay, char>) {
-          // print char instead of number
-          s.assign(1, a0);
-        } else if constexpr (is_etl_string<Decay>::value) {
-          // etl::to_string does not support etl::string arg
-          s.assign(a0);
-        } else {
-          ::etl::to_string(a0, s);
-        }
-        char *end = dest + s.length();
-        return s.length() < real_len ? snformat_impl(end, real_len - s.length(), format + 2, args...) : end;
+        char *end = snformat_value_(dest, real_len, a0);
+        size_t len = end - dest;
+        return len < real_len ? snformat_impl(end, real_len - len, format + 2, args...) : end;
       }
       *dest++ = *format++;
       --i;
@@ -92,6 +343,14 @@ namespace troll {
   */
   template<class ...Args>
   constexpr inline size_t snformat(char *dest, size_t destlen, const char *format, const Args &...args) {
+#if defined(TROLL_INSTRUMENT)
+    if (!__builtin_is_constant_evaluated()) {
+      uint64_t start = instrument_now_();
+      size_t len = snformat_impl(dest, destlen, format, args...) - dest;
+      instrument_format_(format, len, len + 1 == destlen, instrument_now_() - start);
+      return len;
+    }
+#endif
     return snformat_impl(dest, destlen, format, args...) - dest;
   }
 
@@ -105,6 +364,62 @@ namespace troll {
     return snformat(dest, N, format, args...);
   }
 
+  // stands for a length too long for any room, and sums of lengths stop there.
+  static constexpr size_t formatted_too_long_ = size_t(-1) / 2;
+
+  constexpr inline size_t add_formatted_sizes_(size_t a, size_t b) noexcept {
+    return b < formatted_too_long_ && a < formatted_too_long_ - b ? a + b : formatted_too_long_;
+  }
+
+  template<class T>
+  constexpr inline size_t formatted_value_size_(const T &a0);
+
+  template<class It>
+  constexpr inline size_t formatted_range_size_(It first, It last, const char *sep) {
+    size_t n = 0;
+    for (bool head = true; first != last; ++first, head = false) {
+      n = add_formatted_sizes_(add_formatted_sizes_(n, head ? 0 : __builtin_strlen(sep)), formatted_value_size_(*first));
+    }
+    return n;
+  }
+
+  // the length of one value as snformat writes it. Strings and ranges are measured directly, and
+  // other values are formatted into a scratch buffer; one that fills it counts as too long for any
+  // room, as a value that long is only expected from a to_stringer.
+  template<class T>
+  constexpr inline size_t formatted_value_size_(const T &a0) {
+    using Decay = std::decay_t<T>;
+    constexpr bool stringer = !std::is_same_v<decltype(to_stringer<Decay>{}(a0, std::declval<::etl::istring &>())), unsupported_to_string_type>;
+    if constexpr (!stringer && is_format_join<Decay>::value) {
+      return formatted_range_size_(a0.first, a0.last, a0.sep);
+    } else if constexpr (!stringer && is_format_range<std::remove_cv_t<T>>::value) {
+      return formatted_range_size_(std::begin(a0), std::end(a0), ", ");
+    } else if constexpr (!stringer && std::is_pointer_v<Decay> && std::is_same_v<std::remove_const_t<std::remove_pointer_t<Decay>>, char>) {
+      return __builtin_strlen(a0);
+    } else if constexpr (!stringer && (is_etl_string<Decay>::value || is_std_string<Decay>::value)) {
+      return a0.size();
+    } else {
+      char buf[128];
+      size_t n = size_t(snformat_value_(buf, sizeof buf, a0) - buf);
+      return n + 1 < sizeof buf ? n : formatted_too_long_;
+    }
+  }
+
+  // the length of the whole result of snformat with a buffer large enough.
+  constexpr inline size_t formatted_size_(const char *format) {
+    return __builtin_strlen(format);
+  }
+
+  template<class Arg0, class ...Args>
+  constexpr inline size_t formatted_size_(const char *format, const Arg0 &a0, const Args &...args) {
+    for (size_t n = 0; format[n]; ++n) {
+      if (format[n] == '{' && format[n + 1] == '}') {
+        return add_formatted_sizes_(add_formatted_sizes_(n, formatted_value_size_(a0)), formatted_size_(format + n + 2, args...));
+      }
+    }
+    return __builtin_strlen(format);
+  }
+
   /**
    * Formats the string into a string instance with specified capacity template parameter. Same
    * as [`::etl::string`](https://www.etlcpp.com/string.html), the N will not include the nul
@@ -172,6 +487,7 @@ namespace troll {
    * not output the terminating nul.
    * 
    * This function operates on the byte level, which means ANSI codes (colors) are not supported.
+   * See `pad_display` for text with escape codes or UTF-8.
   */
   constexpr inline void pad(char *__restrict__ dest, size_t dest_pad_len, const char *__restrict__ src, size_t srclen, padding p, char padchar = ' ') {
     if (dest_pad_len < srclen) {
@@ -219,6 +535,159 @@ namespace troll {
     dest.uninitialized_resize(padlen);
   }
 
+  /**
+   * Returns true if the text has neither an escape character nor a byte above 0x7f, so that
+   * every byte takes one column. The bytes are checked 8 at a time.
+   */
+  inline bool is_plain_text(const char *src, size_t srclen) noexcept {
+    constexpr uint64_t ones = ~uint64_t(0) / 255, lows = ones * 0x7f, highs = ones * 0x80;
+    size_t i = 0;
+    for (; i + 8 <= srclen; i += 8) {
+      uint64_t v;
+      __builtin_memcpy(&v, src + i, 8);
+      // the high bit of every byte that is above 0x7f or equal to ESC
+      uint64_t x = v ^ (ones * 0x1b);
+      if ((v | ~(((x & lows) + lows) | x)) & highs) {
+        return false;
+      }
+    }
+    for (; i < srclen; ++i) {
+      auto c = static_cast<unsigned char>(src[i]);
+      if (c >= 0x80 || c == 0x1b) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // the number of columns of a code point: 0 for combining marks, 2 for wide characters.
+  constexpr inline size_t code_point_width_(uint32_t cp) noexcept {
+    if ((cp >= 0x0300 && cp <= 0x036f) || (cp >= 0x1ab0 && cp <= 0x1aff) || (cp >= 0x1dc0 && cp <= 0x1dff)
+      || (cp >= 0x200b && cp <= 0x200f) || (cp >= 0x20d0 && cp <= 0x20ff) || (cp >= 0xfe00 && cp <= 0xfe0f)) {
+      return 0;
+    }
+    if ((cp >= 0x1100 && cp <= 0x115f) || (cp >= 0x2e80 && cp <= 0x303e) || (cp >= 0x3041 && cp <= 0x33ff)
+      || (cp >= 0x3400 && cp <= 0x4dbf) || (cp >= 0x4e00 && cp <= 0x9fff) || (cp >= 0xa000 && cp <= 0xa4cf)
+      || (cp >= 0xac00 && cp <= 0xd7a3) || (cp >= 0xf900 && cp <= 0xfaff) || (cp >= 0xfe30 && cp <= 0xfe4f)
+      || (cp >= 0xff00 && cp <= 0xff60) || (cp >= 0xffe0 && cp <= 0xffe6) || (cp >= 0x1f300 && cp <= 0x1f64f)
+      || (cp >= 0x1f900 && cp <= 0x1f9ff) || (cp >= 0x20000 && cp <= 0x3fffd)) {
+      return 2;
+    }
+    return 1;
+  }
+
+  struct display_char_ {
+    // bytes, columns
+    size_t len, width;
+  };
+
+  // measures the escape sequence or character at the start of the text. a byte that does not
+  // start a valid UTF-8 sequence takes one column.
+  constexpr inline display_char_ next_display_char_(const char *src, size_t srclen) noexcept {
+    auto c = static_cast<unsigned char>(src[0]);
+    if (c == 0x1b) {
+      if (srclen > 1 && src[1] == '[') {
+        // CSI: parameters and intermediates up to a final byte in [0x40, 0x7e]
+        size_t i = 2;
+        while (i < srclen && !(src[i] >= 0x40 && src[i] <= 0x7e)) ++i;
+        return {i < srclen ? i + 1 : srclen, 0};
+      }
+      return {srclen > 1 ? size_t(2) : size_t(1), 0};
+    }
+    if (c < 0x80) {
+      return {1, 1};
+    }
+    size_t n = c >= 0xf8 ? 0 : c >= 0xf0 ? 4 : c >= 0xe0 ? 3 : c >= 0xc0 ? 2 : 0;
+    if (!n || n > srclen) {
+      return {1, 1};
+    }
+    uint32_t cp = c & (0x7f >> n);
+    for (size_t i = 1; i < n; ++i) {
+      auto cc = static_cast<unsigned char>(src[i]);
+      if ((cc & 0xc0) != 0x80) {
+        return {1, 1};
+      }
+      cp = cp << 6 | (cc & 0x3f);
+    }
+    return {n, code_point_width_(cp)};
+  }
+
+  /**
+   * Returns the number of terminal columns the text takes up. ANSI escape sequences take none,
+   * and UTF-8 is decoded, with combining marks taking none and wide (East Asian and emoji)
+   * characters taking two. Plain ASCII text is confirmed with `is_plain_text` and not decoded.
+   */
+  constexpr inline size_t display_width(const char *src, size_t srclen) noexcept {
+    if (!__builtin_is_constant_evaluated() && is_plain_text(src, srclen)) {
+      return srclen;
+    }
+    size_t width = 0;
+    for (size_t i = 0; i < srclen;) {
+      auto ch = next_display_char_(src + i, srclen - i);
+      width += ch.width;
+      i += ch.len;
+    }
+    return width;
+  }
+
+  /**
+   * Pads the string to the specified number of columns, the same as `pad`, but measuring the
+   * width as `display_width` does. If the text is wider, the characters that do not fit are left
+   * out, but its escape sequences are still copied so that styles are ended. Writes at most
+   * destlen bytes, which needs to be srclen + width to always fit, and does not output the
+   * terminating nul. If it is shorter, the text stops at the first character that does not fit,
+   * and only the escape sequences after it that fit are copied.
+   *
+   * Returns the number of bytes written.
+   */
+  constexpr inline size_t pad_display(char *__restrict__ dest, size_t destlen, size_t width, const char *__restrict__ src, size_t srclen, padding p, char padchar = ' ') {
+    if (!__builtin_is_constant_evaluated() && is_plain_text(src, srclen)) {
+      width = width < destlen ? width : destlen;
+      pad(dest, width, src, srclen, p, padchar);
+      return width;
+    }
+    // once a character does not fit, no later one is shown either
+    size_t visible = 0;
+    bool full = false;
+    for (size_t i = 0; i < srclen;) {
+      auto ch = next_display_char_(src + i, srclen - i);
+      full = full || visible + ch.width > width;
+      visible += full ? 0 : ch.width;
+      i += ch.len;
+    }
+    size_t left = p == padding::left ? 0 : p == padding::middle ? (width - visible) / 2 : width - visible;
+    size_t n = 0;
+    for (; n < left && n < destlen; ++n) {
+      dest[n] = padchar;
+    }
+    size_t copied = 0;
+    full = false;
+    for (size_t i = 0; i < srclen;) {
+      auto ch = next_display_char_(src + i, srclen - i);
+      // the text stops at the first character that does not fit, and only escapes follow it
+      full = full || copied + ch.width > visible || n + ch.len > destlen;
+      if ((!full || src[i] == '\033') && n + ch.len <= destlen) {
+        for (size_t k = 0; k < ch.len; ++k) {
+          dest[n++] = src[i + k];
+        }
+        copied += ch.width;
+      }
+      i += ch.len;
+    }
+    for (size_t i = left + copied; i < width && n < destlen; ++i) {
+      dest[n++] = padchar;
+    }
+    return n;
+  }
+
+  /**
+   * Pads the source string to width columns, the same as `pad_display`, into an existing string
+   * as far as its capacity allows.
+   */
+  inline void pad_display(::etl::istring &dest, size_t width, ::etl::string_view src, padding p, char padchar = ' ') {
+    dest.uninitialized_resize(pad_display(dest.data(), dest.capacity(), width, src.data(), src.size(), p, padchar));
+  }
+
   enum class ansi_font: uint8_t {
     none          = 0,            // enabler,    disabler
     bold          = 0b0000'0001,  // "\033[1m", "\033[22m"
@@ -252,6 +721,28 @@ namespace troll {
     white   = 8,  // "\033[37m", "\033[47m"
   };
 
+  /**
+   * A string of N characters (and a nul) that is a literal type, so that it can be built at
+   * compile time.
+   */
+  template<size_t N>
+  struct static_string {
+    char data[N + 1];
+
+    // The number of characters, excluding the nul terminator.
+    static constexpr size_t size() noexcept {
+      return N;
+    }
+
+    constexpr const char *c_str() const noexcept {
+      return data;
+    }
+
+    constexpr operator ::etl::string_view() const noexcept {
+      return {data, N};
+    }
+  };
+
   /**
    * A compile-time object that holds ANSI style options and handles the work for escape strings.
    */
@@ -280,54 +771,61 @@ namespace troll {
       + (bg_color == ansi_color::none ? 0 : 2)
       + num_semicolons_) : 0);
 
+    /**
+     * Writes the escape characters used to start the style to dest, which needs room for
+     * enabler_str_size characters, and returns the end. No nul is written.
+     */
+    static constexpr char *write_enabler(char *dest) noexcept {
+      if constexpr (!!num_params_) {
+        char *p = dest;
+        p = strcontcpy(p, "\033[");
+        // font
+        if ((font & ansi_font::bold) == ansi_font::bold)                   p = strcontcpy(p, "1;");
+        if ((font & ansi_font::dim) == ansi_font::dim)                     p = strcontcpy(p, "2;");
+        if ((font & ansi_font::italic) == ansi_font::italic)               p = strcontcpy(p, "3;");
+        if ((font & ansi_font::underline) == ansi_font::underline)         p = strcontcpy(p, "4;");
+        if ((font & ansi_font::blink) == ansi_font::blink)                 p = strcontcpy(p, "5;");
+        if ((font & ansi_font::reverse) == ansi_font::reverse)             p = strcontcpy(p, "7;");
+        if ((font & ansi_font::hidden) == ansi_font::hidden)               p = strcontcpy(p, "8;");
+        if ((font & ansi_font::strikethrough) == ansi_font::strikethrough) p = strcontcpy(p, "9;");
+        // fg color
+        switch (fg_color) {
+          case ansi_color::black:   p = strcontcpy(p, "30;"); break;
+          case ansi_color::red:     p = strcontcpy(p, "31;"); break;
+          case ansi_color::green:   p = strcontcpy(p, "32;"); break;
+          case ansi_color::yellow:  p = strcontcpy(p, "33;"); break;
+          case ansi_color::blue:    p = strcontcpy(p, "34;"); break;
+          case ansi_color::magenta: p = strcontcpy(p, "35;"); break;
+          case ansi_color::cyan:    p = strcontcpy(p, "36;"); break;
+          case ansi_color::white:   p = strcontcpy(p, "37;"); break;
+          default: break;
+        }
+        // bg color
+        switch (bg_color) {
+          case ansi_color::black:   p = strcontcpy(p, "40;"); break;
+          case ansi_color::red:     p = strcontcpy(p, "41;"); break;
+          case ansi_color::green:   p = strcontcpy(p, "42;"); break;
+          case ansi_color::yellow:  p = strcontcpy(p, "43;"); break;
+          case ansi_color::blue:    p = strcontcpy(p, "44;"); break;
+          case ansi_color::magenta: p = strcontcpy(p, "45;"); break;
+          case ansi_color::cyan:    p = strcontcpy(p, "46;"); break;
+          case ansi_color::white:   p = strcontcpy(p, "47;"); break;
+          default: break;
+        }
+        if (*(p - 1) == ';') --p;
+        *p++ = 'm';
+        return p;
+      } else {
+        return dest;
+      }
+    }
+
     // The string of ANSI escape characters used to start the style.
     static ::etl::string_view enabler_str() {
       if constexpr (!!num_params_) {
-        static char buf[enabler_str_size + 1];
-        static bool initialized = false;
-
-        if (!initialized) {
-          char *p = buf;
-          p = strcontcpy(p, "\033[");
-          // font
-          if ((font & ansi_font::bold) == ansi_font::bold)                   p = strcontcpy(p, "1;");
-          if ((font & ansi_font::dim) == ansi_font::dim)                     p = strcontcpy(p, "2;");
-          if ((font & ansi_font::italic) == ansi_font::italic)               p = strcontcpy(p, "3;");
-          if ((font & ansi_font::underline) == ansi_font::underline)         p = strcontcpy(p, "4;");
-          if ((font & ansi_font::blink) == ansi_font::blink)                 p = strcontcpy(p, "5;");
-          if ((font & ansi_font::reverse) == ansi_font::reverse)             p = strcontcpy(p, "7;");
-          if ((font & ansi_font::hidden) == ansi_font::hidden)               p = strcontcpy(p, "8;");
-          if ((font & ansi_font::strikethrough) == ansi_font::strikethrough) p = strcontcpy(p, "9;");
-          // fg color
-          switch (fg_color) {
-            case ansi_color::black:   p = strcontcpy(p, "30;"); break;
-            case ansi_color::red:     p = strcontcpy(p, "31;"); break;
-            case ansi_color::green:   p = strcontcpy(p, "32;"); break;
-            case ansi_color::yellow:  p = strcontcpy(p, "33;"); break;
-            case ansi_color::blue:    p = strcontcpy(p, "34;"); break;
-            case ansi_color::magenta: p = strcontcpy(p, "35;"); break;
-            case ansi_color::cyan:    p = strcontcpy(p, "36;"); break;
-            case ansi_color::white:   p = strcontcpy(p, "37;"); break;
-            default: break;
-          }
-          // bg color
-          switch (bg_color) {
-            case ansi_color::black:   p = strcontcpy(p, "40;"); break;
-            case ansi_color::red:     p = strcontcpy(p, "41;"); break;
-            case ansi_color::green:   p = strcontcpy(p, "42;"); break;
-            case ansi_color::yellow:  p = strcontcpy(p, "43;"); break;
-            case ansi_color::blue:    p = strcontcpy(p, "44;"); break;
-            case ansi_color::magenta: p = strcontcpy(p, "45;"); break;
-            case ansi_color::cyan:    p = strcontcpy(p, "46;"); break;
-            case ansi_color::white:   p = strcontcpy(p, "47;"); break;
-            default: break;
-          }
-          if (*(p - 1) == ';') --p;
-          *p++ = 'm';
-          *p = '\0';
-          initialized = true;
-        }
-        return {buf, enabler_str_size};
+        // built at compile time
+        static constexpr auto buf = enabler_chars_();
+        return {buf.data, enabler_str_size};
       } else {
         return {"", enabler_str_size};
       }
@@ -346,13 +844,274 @@ namespace troll {
       }
     }
 
+    /**
+     * Writes the escape characters used to remove styles to dest, which needs room for
+     * disabler_str_size characters, and returns the end. No nul is written.
+     */
+    static constexpr char *write_disabler(char *dest) noexcept {
+      if constexpr (!!num_params_) {
+        return strcontcpy(dest, "\033[0m");
+      } else {
+        return dest;
+      }
+    }
+
     // The number of extra characters needed to wrap any string with the style.
     static constexpr size_t wrapper_str_size = enabler_str_size + disabler_str_size;
+
+  private:
+    static constexpr static_string<enabler_str_size> enabler_chars_() noexcept {
+      static_string<enabler_str_size> buf {};
+      write_enabler(buf.data);
+      return buf;
+    }
   };
 
+  /**
+   * Wraps the string literal with the enabler and disabler strings of the style at compile time.
+   * The result takes `Style::wrapper_str_size` more characters than the literal.
+   */
+  template<class Style, size_t N>
+  constexpr inline static_string<N - 1 + Style::wrapper_str_size> styled(const char (&label)[N]) noexcept {
+    static_string<N - 1 + Style::wrapper_str_size> buf {};
+    char *p = Style::write_enabler(buf.data);
+    for (size_t i = 0; i + 1 < N; ++i) {
+      *p++ = label[i];
+    }
+    Style::write_disabler(p);
+    return buf;
+  }
+
   using static_ansi_style_options_none_t = static_ansi_style_options<>;
   static constexpr static_ansi_style_options_none_t static_ansi_style_options_none{};
 
+  /**
+   * Builds a string out of several pieces into a fixed buffer, keeping track of where the next
+   * piece goes. Every piece is formatted in place with one bounds check, and whatever does not
+   * fit is cut off and remembered, so truncation only needs to be checked once at the end. The
+   * buffer is always nul terminated.
+   *
+   * One byte of the buffer is kept free to tell a piece that is cut off from one that fits
+   * exactly, so a buffer of destlen bytes holds destlen - 2 characters.
+   */
+  class format_builder {
+  public:
+    /**
+     * Constructor. Starts with an empty string in the buffer, which holds destlen - 1 characters
+     * like `snformat`. An empty buffer holds nothing, and every piece appended to it is cut off.
+     */
+    constexpr format_builder(char *dest, size_t destlen) noexcept
+      : dest_(destlen ? dest : nullptr), cap_(destlen ? destlen - 1 : 0) {
+      if (destlen) {
+        dest[0] = '\0';
+      }
+    }
+
+    /**
+     * The overload is for the case where the buffer size can be automatically deduced if the
+     * destination is an array.
+     */
+    template<size_t N>
+    constexpr format_builder(char (&dest)[N]) noexcept : format_builder(dest, N) {
+      static_assert(N);
+    }
+
+    /**
+     * Appends to the existing contents of the string, whose size is kept up to date after every
+     * piece, up to its whole capacity.
+     */
+    format_builder(::etl::istring &dest) noexcept
+      : dest_(dest.data()), cap_(dest.capacity()), len_(dest.size()), str_(&dest) {}
+
+    /**
+     * Formats the string the same way as `snformat` at the end of the result.
+     */
+    template<class ...Args>
+    constexpr format_builder &append(const char *format, const Args &...args) {
+      if (!dest_) {
+        truncated_ = true;
+        return *this;
+      }
+      size_t room = cap_ - len_;
+      commit_(format_piece_(room, format, args...), room);
+      return *this;
+    }
+
+    /**
+     * Same as `append`, but the piece is wrapped with the enabler and disabler strings of the
+     * style. If the text is cut off, the disabler string still ends it, and if not even the
+     * wrapper fits, nothing is appended.
+     */
+    template<class Style, class ...Args>
+    format_builder &append_styled(const char *format, const Args &...args) {
+      size_t room = cap_ - len_;
+      if (!dest_ || room < Style::wrapper_str_size) {
+        truncated_ = true;
+        return *this;
+      }
+      auto enabler = Style::enabler_str(), disabler = Style::disabler_str();
+      __builtin_memcpy(dest_ + len_, enabler.data(), enabler.size());
+      len_ += enabler.size();
+      room -= Style::wrapper_str_size;
+      size_t n = format_piece_(room, format, args...);
+      if (n > room) {
+        n = room;
+        truncated_ = true;
+      }
+      len_ += n;
+      __builtin_memcpy(dest_ + len_, disabler.data(), disabler.size());
+      commit_(disabler.size(), disabler.size());
+      return *this;
+    }
+
+    /**
+     * Formats the string the same way as `snformat` and pads it to pad_len characters with
+     * padchar, the same as `pad`. A longer string is cut down to pad_len characters, which does
+     * not count as truncation unless the padded piece does not fit.
+     */
+    template<class ...Args>
+    constexpr format_builder &append_padded(size_t pad_len, padding p, char padchar, const char *format, const Args &...args) {
+      if (!dest_) {
+        truncated_ = true;
+        return *this;
+      }
+      size_t room = cap_ - len_;
+      if (pad_len > room) {
+        pad_len = room;
+        truncated_ = true;
+      }
+      char *cell = dest_ + len_;
+      size_t n = snformat(cell, pad_len + 1, format, args...);
+      size_t left = p == padding::left ? 0 : p == padding::middle ? (pad_len - n) / 2 : pad_len - n;
+      // move the text to its place from the back, then fill around it
+      for (size_t i = n; i--;) {
+        cell[left + i] = cell[i];
+      }
+      for (size_t i = 0; i < left; ++i) {
+        cell[i] = padchar;
+      }
+      for (size_t i = left + n; i < pad_len; ++i) {
+        cell[i] = padchar;
+      }
+      commit_(pad_len, pad_len);
+      return *this;
+    }
+
+    /**
+     * Overload that pads with spaces.
+     */
+    template<class ...Args>
+    constexpr format_builder &append_padded(size_t pad_len, padding p, const char *format, const Args &...args) {
+      return append_padded(pad_len, p, ' ', format, args...);
+    }
+
+    // The length of the result, excluding the nul terminator.
+    constexpr size_t size() const noexcept {
+      return len_;
+    }
+
+    // The result string.
+    constexpr ::etl::string_view view() const noexcept {
+      return {dest_, len_};
+    }
+
+    // Whether any piece has been cut off since the builder was created or cleared.
+    constexpr bool truncated() const noexcept {
+      return truncated_;
+    }
+
+    /**
+     * Starts over with an empty string.
+     */
+    constexpr void clear() noexcept {
+      len_ = 0;
+      truncated_ = false;
+      if (dest_) {
+        commit_(0, 0);
+      }
+    }
+
+  private:
+    // formats a piece at the end and returns its length, which is more than room if it is cut
+    // off. Only a piece that fills the room exactly is measured to tell the two apart.
+    template<class ...Args>
+    constexpr size_t format_piece_(size_t room, const char *format, const Args &...args) {
+      size_t n = snformat(dest_ + len_, room + 1, format, args...);
+      return n < room || formatted_size_(format, args...) <= room ? n : room + 1;
+    }
+
+    // takes n characters written at the end, of which at most room fit.
+    constexpr void commit_(size_t n, size_t room) noexcept {
+      if (n > room) {
+        n = room;
+        truncated_ = true;
+      }
+      len_ += n;
+      dest_[len_] = '\0';
+      if (str_) {
+        str_->uninitialized_resize(len_);
+      }
+    }
+
+    char *dest_;
+    size_t cap_;
+    size_t len_ = 0;
+    bool truncated_ = false;
+    ::etl::istring *str_ = nullptr;
+  };
+
+  /**
+   * Writes a snapshot of the formatting and scanning counters into the buffer, one line per
+   * format string, and returns the length of the result. Latency buckets that are not empty are
+   * listed as `log2:count`. Nothing is written unless TROLL_INSTRUMENT is defined.
+   */
+  inline size_t instrument_dump(char *dest, size_t destlen) {
+    if (!destlen) {
+      return 0;
+    }
+    char *end = dest;
+    *end = '\0';
+#if defined(TROLL_INSTRUMENT)
+    // snformat_impl, so that the dump is not counted as well
+    auto append = [dest, destlen, &end](const char *format, const auto &...args) {
+      end = snformat_impl(end, destlen - size_t(end - dest), format, args...);
+    };
+    auto latency = [&append](const instrument_counter *buckets) {
+      for (size_t i = 0; i < instrument_latency_buckets; ++i) {
+        if (instrument_counter n = __atomic_load_n(&buckets[i], __ATOMIC_RELAXED)) {
+          append(" {}:{}", i, n);
+        }
+      }
+      append("\n");
+    };
+    for (auto &site : instrument_format_sites().sites) {
+      if (auto format = __atomic_load_n(&site.format, __ATOMIC_ACQUIRE)) {
+        append("format \"{}\" calls={} bytes={} truncations={} latency", format,
+          __atomic_load_n(&site.calls, __ATOMIC_RELAXED), __atomic_load_n(&site.bytes, __ATOMIC_RELAXED),
+          __atomic_load_n(&site.truncations, __ATOMIC_RELAXED));
+        latency(site.latency);
+      }
+    }
+    for (auto &site : instrument_scan_sites().sites) {
+      if (auto format = __atomic_load_n(&site.format, __ATOMIC_ACQUIRE)) {
+        append("scan \"{}\" matches={} fails={} latency", format,
+          __atomic_load_n(&site.matches, __ATOMIC_RELAXED), __atomic_load_n(&site.fails, __ATOMIC_RELAXED));
+        latency(site.latency);
+      }
+    }
+#endif
+    return size_t(end - dest);
+  }
+
+  /**
+   * The overload is for the case where the buffer size can be automatically deduced if the
+   * destination is an array.
+   */
+  template<size_t N>
+  inline size_t instrument_dump(char (&dest)[N]) {
+    return instrument_dump(dest, N);
+  }
+
   // A helper class to pass arguments for title rows to table builder.
   template<class Heading, class TitleIt, class HeadingStyle, class TitleStyle>
   struct tabulate_title_row_args {
@@ -433,10 +1192,11 @@ namespace troll {
   tabulate_elem_row_args(ElemIt, ElemStyle) -> tabulate_elem_row_args<const char *, ElemIt, ElemStyle, ElemStyle>;
 
   /**
-   * Helper class to tabulate text.
+   * Helper class to tabulate text. Use it as `tabulate`, or as `wide_tabulate` when cells are
+   * measured in display columns.
    */
-  template<size_t ElemsPerRow, size_t HeadingPadding, size_t ContentPadding, class DividerStyle, class TitleRowArgs, class ...ElemRowArgs>
-  class tabulate {
+  template<size_t ElemsPerRow, size_t HeadingPadding, size_t ContentPadding, size_t CellBytes, class DividerStyle, class TitleRowArgs, class ...ElemRowArgs>
+  class basic_tabulate {
   public:
     using size_type = size_t;
     using divider_style_type = DividerStyle;
@@ -451,10 +1211,18 @@ namespace troll {
     static constexpr size_type heading_padding = HeadingPadding;
     // The fixed width of the columns on the right (content column).
     static constexpr size_type content_padding = ContentPadding;
+    // The most bytes of text a cell keeps when it is measured in display columns (see
+    // `make_wide_tabulate`), or zero if cells are padded byte by byte.
+    static constexpr size_type cell_bytes = CellBytes;
     // The maximum width of any row in the result.
     // Calculated based on the number of elements per row and formatting, excluding escapes.
     static constexpr size_type max_line_width = HeadingPadding + ElemsPerRow * ContentPadding + 10/*safety*/;
 
+    // Whether the title and element iterators are all random access, so that any row group can
+    // be reached without walking the rows before it.
+    static constexpr bool random_access_src = is_random_access_iterator_v<typename TitleRowArgs::title_it_type>
+      && (is_random_access_iterator_v<typename ElemRowArgs::elem_it_type> && ...);
+
     // Characters for table dividers.
     char divider_horizontal = '-';
     char divider_vertical = '|';
@@ -462,11 +1230,11 @@ namespace troll {
 
     // Constructor. To avoid passing excess template parameters, use `make_tabulate` instead.
     template<class Tit, class ...Elems>
-    constexpr tabulate(Tit &&title, Elems &&...elems)
+    constexpr basic_tabulate(Tit &&title, Elems &&...elems)
       : title_row_args_{std::forward<Tit>(title)}
       , elem_row_args_{std::forward<Elems>(elems)...}
     {
-      auto title_heading = sformat<heading_padding>("{}", title_row_args_.heading);
+      auto title_heading = sformat<heading_bytes_>("{}", title_row_args_.heading);
       has_heading_ = title_heading.size();
       auto total_pad = elems_per_row * content_padding + (has_heading_ ? heading_padding : 0);
       // write the divider line
@@ -479,6 +1247,7 @@ namespace troll {
       *p++ = divider_cross;
       p = strcontcpy(p, divider_style_type::disabler_str().data());
       *p = '\0';
+      divider_len_ = p - divider_text_;
 
       // prepare prefix and suffix for title row
       troll::pad(title_text_, sizeof title_text_, "", 0, padding::left);
@@ -490,25 +1259,24 @@ namespace troll {
       if constexpr (title_row_args_type::style_is_same) {
         p = strcontcpy(p, title_row_args_type::title_style_type::enabler_str().data());
         if (has_heading_) {
-          troll::pad(p, heading_padding, title_heading.data(), title_heading.size(), padding::middle);
-          p += heading_padding;
+          p = put_heading_(p, title_heading);
         }
       } else {
         if (has_heading_) {
           p = strcontcpy(p, title_row_args_type::heading_style_type::enabler_str().data());
-          troll::pad(p, heading_padding, title_heading.data(), title_heading.size(), padding::middle);
-          p += heading_padding;
+          p = put_heading_(p, title_heading);
           p = strcontcpy(p, title_row_args_type::heading_style_type::disabler_str().data());
         }
         p = strcontcpy(p, title_row_args_type::title_style_type::enabler_str().data());
       }
       title_begin_ = p;
-      p += elems_per_row * content_padding;
+      p += elems_per_row * cell_room_;
       p = strcontcpy(p, title_row_args_type::title_style_type::disabler_str().data());
       p = strcontcpy(p, divider_style_type::enabler_str().data());
       *p++ = divider_vertical;
       p = strcontcpy(p, divider_style_type::disabler_str().data());
       *p = '\0';
+      title_len_ = p - title_text_;
 
       // prepare prefix and suffix for element rows
       prepare_elem_row_(std::make_index_sequence<num_elem_row_args>{});
@@ -529,30 +1297,83 @@ namespace troll {
       p = strcontcpy(p, divider_style_type::enabler_str().data());
       *p++ = divider_vertical;
       p = strcontcpy(p, divider_style_type::disabler_str().data());
-      auto heading = sformat<heading_padding>("{}", args.heading);
+      auto heading = sformat<heading_bytes_>("{}", args.heading);
 
       if constexpr (ArgT::style_is_same) {
         p = strcontcpy(p, ArgT::elem_style_type::enabler_str().data());
         if (has_heading_) {
-          troll::pad(p, heading_padding, heading.data(), heading.size(), padding::middle);
-          p += heading_padding;
+          p = put_heading_(p, heading);
         }
       } else {
         if (has_heading_) {
           p = strcontcpy(p, ArgT::heading_style_type::enabler_str().data());
-          troll::pad(p, heading_padding, heading.data(), heading.size(), padding::middle);
-          p += heading_padding;
+          p = put_heading_(p, heading);
           p = strcontcpy(p, ArgT::heading_style_type::disabler_str().data());
         }
         p = strcontcpy(p, ArgT::elem_style_type::enabler_str().data());
       }
       elem_begins_[I] = p;
-      p += elems_per_row * content_padding;
+      p += elems_per_row * cell_room_;
       p = strcontcpy(p, ArgT::elem_style_type::disabler_str().data());
       p = strcontcpy(p, divider_style_type::enabler_str().data());
       *p++ = divider_vertical;
       p = strcontcpy(p, divider_style_type::disabler_str().data());
       *p = '\0';
+      elem_lens_[I] = p - std::get<I>(elem_texts_);
+    }
+
+    // writes a heading centered in its column and returns the end.
+    template<class S>
+    static char *put_heading_(char *p, const S &heading) {
+      if constexpr (wide_cells_) {
+        return p + pad_display(p, heading_room_, heading_padding, heading.data(), heading.size(), padding::middle);
+      } else {
+        troll::pad(p, heading_padding, heading.data(), heading.size(), padding::middle);
+        return p + heading_padding;
+      }
+    }
+
+    // writes the value centered in its column and returns the end.
+    template<class T>
+    static char *put_cell_(char *cell, const T &v) {
+      if constexpr (wide_cells_) {
+        char text[cell_bytes + 1];
+        size_type sz = snformat(text, sizeof text, "{}", v);
+        return cell + pad_display(cell, cell_room_, content_padding, text, sz, padding::middle);
+      } else {
+        format_cell_(cell, v);
+        return cell + content_padding;
+      }
+    }
+
+    // formats the value straight into its column and centers it in place.
+    template<class T>
+    static void format_cell_(char *cell, const T &v) {
+      // snformat always writes a nul, which would land on the next column or the row suffix
+      char after = cell[content_padding];
+      size_type sz = snformat(cell, content_padding + 1, "{}", v);
+      cell[content_padding] = after;
+      size_type left = (content_padding - sz) / 2;
+      if (left) {
+        __builtin_memmove(cell + left, cell, sz);
+        __builtin_memset(cell, ' ', left);
+      }
+      __builtin_memset(cell + left + sz, ' ', content_padding - left - sz);
+    }
+
+    // clears the columns after the first `used` ones, given where they start, and returns the end.
+    static char *blank_cells_(char *p, size_type used) {
+      __builtin_memset(p, ' ', (elems_per_row - used) * content_padding);
+      return p + (elems_per_row - used) * content_padding;
+    }
+
+    // ends a row of wide cells after where its cells went, since its length varies.
+    template<class Style>
+    char *put_suffix_(char *p) const {
+      p = strcontcpy(p, Style::disabler_str().data());
+      p = strcontcpy(p, divider_style_type::enabler_str().data());
+      *p++ = divider_vertical;
+      return strcontcpy(p, divider_style_type::disabler_str().data());
     }
 
   public:
@@ -612,16 +1433,17 @@ namespace troll {
 
       constexpr iterator &operator++() {
         if (state_ == state::top_line) {
-          char buf[content_padding + 1];
           // write down the titles
           size_type titles = 0;
-          auto &end = that_->title_row_args_.end;
-          for (; title_it_ != end && titles < elems_per_row; ++title_it_, ++titles) {
-            auto sz = snformat(buf, content_padding + 1, "{}", *title_it_);
-            troll::pad(that_->title_begin_ + titles * content_padding, content_padding, buf, sz, padding::middle);
+          char *p = that_->title_begin_;
+          for (; title_it_ != title_end_ && titles < elems_per_row; ++title_it_, ++titles) {
+            p = basic_tabulate::put_cell_(p, *title_it_);
           }
           // in case row is not full
-          troll::pad(that_->title_begin_ + titles * content_padding, elems_per_row * content_padding - titles * content_padding, "", 0, padding::left);
+          p = basic_tabulate::blank_cells_(p, titles);
+          if constexpr (wide_cells_) {
+            *that_->template put_suffix_<typename title_row_args_type::title_style_type>(p) = '\0';
+          }
 
           if (titles == 0) {
             // no more
@@ -662,21 +1484,23 @@ namespace troll {
 
       template<size_type I>
       void do_elem_row_(size_type titles) {
-        char buf[content_padding + 1];
         auto &it = std::get<I>(*elem_its_);
         char *p = that_->elem_begins_[I];
         for (size_type elems = 0; elems < titles; ++it, ++elems) {
-          auto sz = snformat(buf, content_padding + 1, "{}", *it);
-          troll::pad(p + elems * content_padding, content_padding, buf, sz, padding::middle);
+          p = basic_tabulate::put_cell_(p, *it);
         }
         // in case row is not full
-        troll::pad(p + titles * content_padding, elems_per_row * content_padding - titles * content_padding, "", 0, padding::left);
+        p = basic_tabulate::blank_cells_(p, titles);
+        if constexpr (wide_cells_) {
+          using style = typename std::tuple_element_t<I, elem_row_args_type>::elem_style_type;
+          *that_->template put_suffix_<style>(p) = '\0';
+        }
       }
 
-      friend class tabulate;
+      friend class basic_tabulate;
 
-      tabulate *that_;
-      typename title_row_args_type::title_it_type title_it_;
+      basic_tabulate *that_;
+      typename title_row_args_type::title_it_type title_it_, title_end_;
 
       ::etl::optional<std::tuple<typename ElemRowArgs::elem_it_type...>> elem_its_;
 
@@ -689,17 +1513,18 @@ namespace troll {
       } state_;
       size_type state_which_elem_ = 0;
 
-      template<class T, class E>
-      iterator(tabulate *tab, T &&title_begin, E &&elem_begins, state s = state::top_line)
-        : that_{tab}, title_it_{std::forward<T>(title_begin)}, elem_its_{std::forward<E>(elem_begins)}, state_{s} {}
+      template<class T1, class T2, class E>
+      iterator(basic_tabulate *tab, T1 &&title_begin, T2 &&title_end, E &&elem_begins, state s = state::top_line)
+        : that_{tab}, title_it_{std::forward<T1>(title_begin)}, title_end_{std::forward<T2>(title_end)}
+        , elem_its_{std::forward<E>(elem_begins)}, state_{s} {}
     };
 
     constexpr iterator begin() {
-      return iterator{this, title_row_args_.begin, project_elem_its_(std::make_index_sequence<num_elem_row_args>{})};
+      return iterator{this, title_row_args_.begin, title_row_args_.end, project_elem_its_(std::make_index_sequence<num_elem_row_args>{})};
     }
 
     constexpr iterator end() {
-      return iterator{this, title_row_args_.end, ::etl::nullopt, iterator::state::end};
+      return iterator{this, title_row_args_.end, title_row_args_.end, ::etl::nullopt, iterator::state::end};
     }
 
     /**
@@ -714,6 +1539,166 @@ namespace troll {
       reset_elem_begins_(std::make_index_sequence<num_elem_row_args>{}, std::forward<Elems>(elem_begins)...);
     }
 
+    /**
+     * Returns the exact number of characters (excluding the nul) `render_into` writes for a table
+     * with num_titles titles. Every line is followed by a `\n`. With wide cells the rows differ in
+     * length, and it is the most that can be written instead.
+     */
+    constexpr size_type render_size(size_type num_titles) const {
+      size_type groups = (num_titles + elems_per_row - 1) / elems_per_row;
+      return divider_len_ + 1 + groups * row_group_size();
+    }
+
+    /**
+     * Same as above, but counts the titles in the current title range.
+     */
+    constexpr size_type render_size() const {
+      return render_size(num_titles_());
+    }
+
+    /**
+     * Renders the whole table into the buffer in one pass and returns the length of the result,
+     * the same as iterating the table and writing each line followed by a `\n`. Cells are
+     * formatted directly into the buffer.
+     * This function _will_ output the nul terminator. If the buffer is too small, only the lines
+     * that fit in entirely are written. This function does not overflow the buffer.
+     */
+    size_type render_into(char *dest, size_type destlen) const {
+      return render_page(dest, destlen, 0, size_type(-1));
+    }
+
+    /**
+     * The overload is for the case where the buffer size can be automatically deduced if the
+     * destination is an array.
+     */
+    template<size_t N>
+    size_type render_into(char (&dest)[N]) const {
+      static_assert(N);
+      return render_into(dest, N);
+    }
+
+    /**
+     * Returns the number of row groups in the current title range. A row group is a title row
+     * together with the element rows below it, each preceded by a divider line.
+     */
+    constexpr size_type num_row_groups() const {
+      return (num_titles_() + elems_per_row - 1) / elems_per_row;
+    }
+
+    /**
+     * Returns the number of characters every row group takes when rendered, or at most takes with
+     * wide cells. The whole table is `num_row_groups()` row groups followed by one divider line.
+     */
+    constexpr size_type row_group_size() const {
+      size_type group = (num_elem_row_args + 1) * (divider_len_ + 1) + title_len_ + 1;
+      for (size_type i = 0; i < num_elem_row_args; ++i) {
+        group += elem_lens_[i] + 1;
+      }
+      return group;
+    }
+
+    /**
+     * Renders num_groups row groups starting from first_group into the buffer and returns the
+     * number of characters written. Only the row groups that fit in entirely are written, and
+     * this function does not output the nul terminator nor the closing divider line.
+     * The source iterators jump to the row group directly if `random_access_src`, otherwise the
+     * rows before it are stepped over without being formatted. With wide cells the row groups
+     * differ in length, so their place in a whole table is not `first_group * row_group_size()`.
+     * The object is not modified, so different row groups can be rendered concurrently.
+     */
+    size_type render_groups_into(char *dest, size_type destlen, size_type first_group, size_type num_groups) const {
+      char *p = dest;
+      render_groups_(p, dest + destlen, first_group, num_groups);
+      return p - dest;
+    }
+
+    /**
+     * Renders num_groups row groups starting from first_group, followed by the closing divider
+     * line, into the buffer and returns the length of the result. The result is the same as
+     * `render_into` on a table holding only these row groups, so it can be used to show one page
+     * of a long table. See `render_groups_into` for how the row group is reached.
+     * This function _will_ output the nul terminator. If the buffer is too small, only the lines
+     * that fit in entirely are written. This function does not overflow the buffer.
+     */
+    size_type render_page(char *dest, size_type destlen, size_type first_group, size_type num_groups) const {
+      if (!destlen) {
+        return 0;
+      }
+      char *p = dest;
+      char *last = dest + destlen - 1;
+      if (render_groups_(p, last, first_group, num_groups)) {
+        render_line_(p, last, divider_text_, divider_len_);
+      }
+      *p = '\0';
+      return p - dest;
+    }
+
+    /**
+     * A range of lines covering num_groups row groups starting from first_group, followed by the
+     * closing divider line. It yields the same lines as iterating a table holding only these row
+     * groups. See `render_groups_into` for how the row group is reached.
+     */
+    class viewport_type {
+    public:
+      constexpr iterator begin() const {
+        return begin_;
+      }
+      constexpr iterator end() const {
+        return end_;
+      }
+
+    private:
+      friend class basic_tabulate;
+      constexpr viewport_type(iterator begin, iterator end) : begin_{begin}, end_{end} {}
+      iterator begin_, end_;
+    };
+
+    // Returns the viewport of num_groups row groups starting from first_group.
+    constexpr viewport_type viewport(size_type first_group, size_type num_groups) {
+      auto title_it = title_row_args_.begin;
+      auto skip = seek_titles_(title_it, group_titles_(first_group));
+      auto title_end = title_it;
+      seek_titles_(title_end, group_titles_(num_groups));
+      return {
+        iterator{this, title_it, title_end, advance_elem_its_(std::make_index_sequence<num_elem_row_args>{}, skip)},
+        iterator{this, title_end, title_end, ::etl::nullopt, iterator::state::end},
+      };
+    }
+
+    /**
+     * Renders the whole table into an existing string instance and returns the result length,
+     * which excludes the nul terminator. The string itself's capacity is used.
+     */
+    size_type render_to(::etl::istring &dest) {
+      auto sz = render_into(dest.data(), dest.capacity() + 1);
+      dest.uninitialized_resize(sz);
+      return sz;
+    }
+
+    /**
+     * Renders the whole table and passes it to the sink one row group at a time, as
+     * `sink(const char *data, size_type len)`, and returns the total length. The pieces add up to
+     * the same characters as `render_into`, without the nul terminator, and are only valid during
+     * the call. The pieces are formatted in a buffer on the stack that holds one row group.
+     */
+    template<class Sink, class = std::enable_if_t<std::is_invocable_v<Sink &, const char *, size_type>>>
+    size_type render_to(Sink &&sink) const {
+      char buf[(num_elem_row_args + 1) * (sizeof(divider_text_) + 1) + sizeof(title_text_) + 1 + sizeof(elem_texts_) + num_elem_row_args];
+      auto title_it = title_row_args_.begin;
+      auto elem_its = advance_elem_its_(std::make_index_sequence<num_elem_row_args>{}, 0);
+      size_type total = 0;
+      while (title_it != title_row_args_.end) {
+        char *p = buf;
+        render_group_(p, buf + sizeof(buf), title_it, elem_its);
+        sink(static_cast<const char *>(buf), size_type(p - buf));
+        total += p - buf;
+      }
+      char *p = buf;
+      render_line_(p, buf + sizeof(buf), divider_text_, divider_len_);
+      sink(static_cast<const char *>(buf), size_type(p - buf));
+      return total + (p - buf);
+    }
+
     /**
      * Returns the column, row, and a string to be used to patch a already printed table if the
      * value in it is supposed to change _(only modify)_.
@@ -727,17 +1712,17 @@ namespace troll {
       size_t col = 1 + (has_heading_ ? HeadingPadding : 0) + (it_index % elems_per_row) * ContentPadding;
       size_t skip_full_rows = it_index / elems_per_row;
       size_t row = (skip_full_rows * (1 + num_elem_row_args) + ArgRow) * 2 + 1;
-      auto padded = pad<ContentPadding>(sformat<ContentPadding>("{}", v), padding::middle);
+      auto padded = patch_cell_(v);
 
       if constexpr (ArgRow == 0) {
         using style = typename title_row_args_type::title_style_type;
-        auto str = sformat<style::wrapper_str_size + ContentPadding>(
+        auto str = sformat<style::wrapper_str_size + cell_room_>(
           "{}{}{}", style::enabler_str(), padded, style::disabler_str()
         );
         return std::make_tuple(row, col, str);
       } else {
         using style = typename std::tuple_element_t<ArgRow - 1, elem_row_args_type>::elem_style_type;
-        auto str = sformat<style::wrapper_str_size + ContentPadding>(
+        auto str = sformat<style::wrapper_str_size + cell_room_>(
           "{}{}{}", style::enabler_str(), padded, style::disabler_str()
         );
         return std::make_tuple(row, col, str);
@@ -745,6 +1730,19 @@ namespace troll {
     }
 
   private:
+    // the cell text patch_str puts between the style escapes.
+    template<class V>
+    static constexpr auto patch_cell_(const V &v) {
+      if constexpr (wide_cells_) {
+        auto text = sformat<cell_bytes>("{}", v);
+        ::etl::string<cell_room_> padded;
+        pad_display(padded, content_padding, text, padding::middle);
+        return padded;
+      } else {
+        return pad<ContentPadding>(sformat<ContentPadding>("{}", v), padding::middle);
+      }
+    }
+
     template<size_type ...I, class ...Elems>
     constexpr void reset_elem_begins_(std::index_sequence<I...>, Elems &&...elem_begins) {
       ((void)(std::get<I>(elem_row_args_).begin = std::forward<Elems>(elem_begins)), ...);
@@ -755,8 +1753,148 @@ namespace troll {
       return std::make_tuple(std::get<I>(elem_row_args_).begin...);
     }
 
+    template<size_type ...I>
+    constexpr auto advance_elem_its_(std::index_sequence<I...>, size_type n) const {
+      (void)n;  // suppress unused warning if there is no element rows
+      return std::make_tuple(next_elem_it_(std::get<I>(elem_row_args_).begin, n)...);
+    }
+
+    template<class It>
+    static constexpr It next_elem_it_(It it, size_type n) {
+      if constexpr (is_random_access_iterator_v<It>) {
+        return it + n;
+      } else {
+        return std::next(it, n);
+      }
+    }
+
+    // the number of titles in num_groups row groups, saturated.
+    static constexpr size_type group_titles_(size_type num_groups) {
+      return num_groups < size_type(-1) / elems_per_row ? num_groups * elems_per_row : size_type(-1);
+    }
+
+    // the number of titles in the current title range.
+    constexpr size_type num_titles_() const {
+      if constexpr (is_random_access_iterator_v<typename title_row_args_type::title_it_type>) {
+        return size_type(title_row_args_.end - title_row_args_.begin);
+      } else {
+        return size_type(std::distance(title_row_args_.begin, title_row_args_.end));
+      }
+    }
+
+    // moves the title iterator forward by n but not past the end, returns the distance moved.
+    constexpr size_type seek_titles_(typename title_row_args_type::title_it_type &it, size_type n) const {
+      if constexpr (is_random_access_iterator_v<typename title_row_args_type::title_it_type>) {
+        auto remain = size_type(title_row_args_.end - it);
+        n = n < remain ? n : remain;
+        it += n;
+        return n;
+      } else {
+        size_type i = 0;
+        for (; i < n && it != title_row_args_.end; ++i, ++it) {}
+        return i;
+      }
+    }
+
+    // renders up to num_groups row groups from first_group, returns false if out of space.
+    bool render_groups_(char *&p, const char *last, size_type first_group, size_type num_groups) const {
+      auto title_it = title_row_args_.begin;
+      auto skip = seek_titles_(title_it, group_titles_(first_group));
+      auto elem_its = advance_elem_its_(std::make_index_sequence<num_elem_row_args>{}, skip);
+      for (; num_groups && title_it != title_row_args_.end; --num_groups) {
+        if (!render_group_(p, last, title_it, elem_its)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // renders a divider, a title row and the element rows below it if they fit before last.
+    template<class Its>
+    bool render_group_(char *&p, const char *last, typename title_row_args_type::title_it_type &title_it, Its &elem_its) const {
+      if (!render_line_(p, last, divider_text_, divider_len_) || size_type(last - p) < title_len_ + 1) {
+        return false;
+      }
+      p = copy_prefix_(p, title_text_, title_begin_);
+      char *cells = p;
+      size_type titles = 0;
+      for (; title_it != title_row_args_.end && titles < elems_per_row; ++title_it, ++titles) {
+        p = put_cell_(p, *title_it);
+      }
+      p = blank_cells_(p, titles);
+      if constexpr (wide_cells_) {
+        p = put_suffix_<typename title_row_args_type::title_style_type>(p);
+        *p++ = '\n';
+      } else {
+        p = copy_suffix_(cells, title_text_, title_begin_, title_len_);
+      }
+      return render_elem_rows_(std::make_index_sequence<num_elem_row_args>{}, p, last, elem_its, titles);
+    }
+
+    // copies a whole line plus a newline if it fits before last.
+    static bool render_line_(char *&p, const char *last, const char *text, size_type len) {
+      if (size_type(last - p) < len + 1) {
+        return false;
+      }
+      __builtin_memcpy(p, text, len);
+      p += len;
+      *p++ = '\n';
+      return true;
+    }
+
+    // copies the part of a row before its cells and returns where the cells go.
+    static char *copy_prefix_(char *p, const char *text, const char *cells) {
+      __builtin_memcpy(p, text, cells - text);
+      return p + (cells - text);
+    }
+
+    // copies the part of a row after its cells plus a newline, given where the cells went.
+    static char *copy_suffix_(char *p, const char *text, const char *cells, size_type len) {
+      const char *suffix = cells + elems_per_row * content_padding;
+      size_type suffix_len = len - (suffix - text);
+      p += elems_per_row * content_padding;
+      __builtin_memcpy(p, suffix, suffix_len);
+      p += suffix_len;
+      *p++ = '\n';
+      return p;
+    }
+
+    template<size_type ...I, class Its>
+    bool render_elem_rows_(std::index_sequence<I...>, char *&p, const char *last, Its &its, size_type titles) const {
+      (void)p; (void)last; (void)its; (void)titles;  // suppress unused warning if there is no element rows
+      return (render_elem_row_<I>(p, last, std::get<I>(its), titles) && ...);
+    }
+
+    template<size_type I, class It>
+    bool render_elem_row_(char *&p, const char *last, It &it, size_type titles) const {
+      if (!render_line_(p, last, divider_text_, divider_len_) || size_type(last - p) < elem_lens_[I] + 1) {
+        return false;
+      }
+      const char *text = std::get<I>(elem_texts_);
+      p = copy_prefix_(p, text, elem_begins_[I]);
+      char *cells = p;
+      for (size_type elems = 0; elems < titles; ++it, ++elems) {
+        p = put_cell_(p, *it);
+      }
+      p = blank_cells_(p, titles);
+      if constexpr (wide_cells_) {
+        p = put_suffix_<typename std::tuple_element_t<I, elem_row_args_type>::elem_style_type>(p);
+        *p++ = '\n';
+      } else {
+        p = copy_suffix_(cells, text, elem_begins_[I], elem_lens_[I]);
+      }
+      return true;
+    }
+
     friend class iterator;
 
+    static constexpr bool wide_cells_ = CellBytes > 0;
+    // the most bytes a heading or a cell takes in a row
+    static constexpr size_type heading_bytes_ = wide_cells_ ? HeadingPadding + CellBytes : HeadingPadding;
+    static constexpr size_type heading_room_ = wide_cells_ ? heading_bytes_ + HeadingPadding : HeadingPadding;
+    static constexpr size_type cell_room_ = wide_cells_ ? CellBytes + ContentPadding : ContentPadding;
+    static constexpr size_type max_line_bytes_ = heading_room_ + ElemsPerRow * cell_room_ + 10/*safety*/;
+
     bool has_heading_ = false;
     title_row_args_type title_row_args_;
     elem_row_args_type elem_row_args_;
@@ -765,7 +1903,7 @@ namespace troll {
     char divider_text_[max_line_width + divider_wrapper_size_];
 
     char title_text_[  // precalculate buffer size
-      max_line_width
+      max_line_bytes_
       + title_row_args_type::heading_style_type::wrapper_str_size
       + (title_row_args_type::style_is_same ? 0 : title_row_args_type::title_style_type::wrapper_str_size)
       + divider_wrapper_size_ * 2
@@ -773,14 +1911,32 @@ namespace troll {
     char *title_begin_ = 0;
 
     std::tuple<char[  // precalculate buffer size
-      max_line_width
+      max_line_bytes_
       + ElemRowArgs::heading_style_type::wrapper_str_size
       + (ElemRowArgs::style_is_same ? 0 : ElemRowArgs::elem_style_type::wrapper_str_size)
       + divider_wrapper_size_ * 2
     ]...> elem_texts_;
     char *elem_begins_[num_elem_row_args ? num_elem_row_args : 1];
+
+    // lengths of the lines above, excluding the nul
+    size_type divider_len_ = 0;
+    size_type title_len_ = 0;
+    size_type elem_lens_[num_elem_row_args ? num_elem_row_args : 1] = {};
   };
 
+  /**
+   * A table whose cells are padded byte by byte.
+   */
+  template<size_t ElemsPerRow, size_t HeadingPadding, size_t ContentPadding, class DividerStyle, class TitleRowArgs, class ...ElemRowArgs>
+  using tabulate = basic_tabulate<ElemsPerRow, HeadingPadding, ContentPadding, 0, DividerStyle, TitleRowArgs, ElemRowArgs...>;
+
+  /**
+   * A table whose headings and cells are centered by their display width, keeping at most
+   * CellBytes bytes of text per cell. Its rows differ in length.
+   */
+  template<size_t ElemsPerRow, size_t HeadingPadding, size_t ContentPadding, size_t CellBytes, class DividerStyle, class TitleRowArgs, class ...ElemRowArgs>
+  using wide_tabulate = basic_tabulate<ElemsPerRow, HeadingPadding, ContentPadding, CellBytes, DividerStyle, TitleRowArgs, ElemRowArgs...>;
+
   /**
    * Helper function to make a tabulator when leftmost (heading) column have a different width than
    * the right-hand-side columns.
@@ -817,6 +1973,35 @@ namespace troll {
     };
   }
 
+  /**
+   * Same as `make_tabulate`, but headings and cells are centered by their display width with
+   * `pad_display`, so that styled or UTF-8 text lines up. The text of a cell is cut at CellBytes
+   * bytes, and rows differ in length, so `render_size` becomes the most that can be written.
+   * Template arguments:
+   *   - ElemsPerRow: The maximum number of elements per row.
+   *   - HeadingPadding: The width of the leftmost (heading) column, in columns.
+   *   - ContentPadding: The width of the columns on the right (content column), in columns.
+   *   - CellBytes: The most bytes of text kept for a cell.
+   */
+  template<size_t ElemsPerRow, size_t HeadingPadding, size_t ContentPadding, size_t CellBytes, class DividerStyle, class TitleRowArgs, class ...ElemRowArgs>
+  constexpr auto make_wide_tabulate(DividerStyle, TitleRowArgs &&title, ElemRowArgs &&...elems) {
+    static_assert(CellBytes, "a cell needs room for its text");
+    return wide_tabulate<ElemsPerRow, HeadingPadding, ContentPadding, CellBytes, DividerStyle, TitleRowArgs, ElemRowArgs...>{
+      std::forward<TitleRowArgs>(title), std::forward<ElemRowArgs>(elems)...
+    };
+  }
+
+  /**
+   * Same as above, but all columns have the same width.
+   */
+  template<size_t ElemsPerRow, size_t Padding, size_t CellBytes, class DividerStyle, class TitleRowArgs, class ...ElemRowArgs>
+  constexpr auto make_wide_tabulate(DividerStyle, TitleRowArgs &&title, ElemRowArgs &&...elems) {
+    static_assert(CellBytes, "a cell needs room for its text");
+    return wide_tabulate<ElemsPerRow, Padding, Padding, CellBytes, DividerStyle, TitleRowArgs, ElemRowArgs...>{
+      std::forward<TitleRowArgs>(title), std::forward<ElemRowArgs>(elems)...
+    };
+  }
+
   /**
    * The class supports specifying text at a certain line and at a certain column.
    * It maintains an internal queue for texts, and when on demand, it will output a
@@ -857,10 +2042,16 @@ namespace troll {
      */
     size_type enqueue(size_type line, size_type column, const char *text) {
       if (queue_.full()) {
+#if defined(TROLL_INSTRUMENT)
+        ++stats_.drops;
+#endif
         return 0;
       }
       // TODO: emplace only if text compares different
       queue_.emplace();
+#if defined(TROLL_INSTRUMENT)
+      stats_.max_queue_depth = ::etl::max(stats_.max_queue_depth, size_type(queue_.size()));
+#endif
       Request &ref = queue_.back();
       ref.line = line;
       ref.column = column;
@@ -885,6 +2076,11 @@ namespace troll {
     // and prints text directly, this will make sure it would behave as expected.
     sz += snformat(current_text_ + sz, sizeof current_text_ - sz, move_cursor_to_bottom_);
     queue_.pop();
+#if defined(TROLL_INSTRUMENT)
+    ++stats_.dequeues;
+    stats_.dequeued_bytes += sz;
+    stats_.max_dequeue_bytes = ::etl::max(stats_.max_dequeue_bytes, sz);
+#endif
     return {current_text_, sz};
   }
 
@@ -892,6 +2088,13 @@ namespace troll {
     return queue_.empty();
   }
 
+#if defined(TROLL_INSTRUMENT)
+  // The counters of this object. Only available if TROLL_INSTRUMENT is defined.
+  const output_control_stats &stats() const {
+    return stats_;
+  }
+#endif
+
   private:
     struct Request {
       size_type line;
@@ -904,5 +2107,8 @@ namespace troll {
     char move_cursor_to_bottom_[10];
     char current_text_[max_line_width + ansi_code_size + sizeof move_cursor_to_bottom_];
     ::etl::queue<Request, max_queue_size> queue_;
+#if defined(TROLL_INSTRUMENT)
+    output_control_stats stats_ {};
+#endif
   };
 }  // namespace troll
@@ -0,0 +1,68 @@
+/**
+ * -- troll --
+ *
+ * Copyright (c) 2023 dearoneesama
+ *
+ * This software is licensed under MIT License.
+ */
+
+#pragma once
+
+#include <thread>
+#include <vector>
+#include "format.hpp"
+
+// utilities in this header require a hosted environment (threads).
+
+namespace troll {
+
+  /**
+   * Renders the whole table into the buffer and returns the length of the result, the same as
+   * `tabulate::render_into`. The row groups are split into chunks and every chunk is rendered on
+   * its own thread into its precalculated slice of the buffer, so the output is identical to
+   * rendering serially.
+   * Falls back to `tabulate::render_into` if the source iterators are not random access, the
+   * table has wide cells (see `make_wide_tabulate`), whose row groups differ in length, the
+   * buffer is too small or there is not enough work for more than one thread.
+   */
+  template<class Tabulate>
+  inline size_t render_into_parallel(Tabulate &tab, char *dest, size_t destlen, size_t num_threads = std::thread::hardware_concurrency()) {
+    if constexpr (!Tabulate::random_access_src || Tabulate::cell_bytes > 0) {
+      (void)num_threads;
+      return tab.render_into(dest, destlen);
+    } else {
+      size_t groups = tab.num_row_groups();
+      size_t size = tab.render_size();
+      if (num_threads > groups) {
+        num_threads = groups;
+      }
+      if (num_threads < 2 || destlen < size + 1) {
+        return tab.render_into(dest, destlen);
+      }
+
+      size_t group_size = tab.row_group_size();
+      size_t per_thread = (groups + num_threads - 1) / num_threads;
+      const auto &ctab = tab;
+      auto work = [&ctab, dest, group_size](size_t first, size_t n) {
+        ctab.render_groups_into(dest + first * group_size, n * group_size, first, n);
+      };
+
+      std::vector<std::thread> workers;
+      workers.reserve(num_threads - 1);
+      // the calling thread takes the first chunk
+      for (size_t first = per_thread; first < groups; first += per_thread) {
+        workers.emplace_back(work, first, first + per_thread < groups ? per_thread : groups - first);
+      }
+      work(0, per_thread);
+      for (auto &w : workers) {
+        w.join();
+      }
+
+      // every row group starts with a divider line, so the closing one is copied from the top
+      __builtin_memcpy(dest + groups * group_size, dest, size - groups * group_size);
+      dest[size] = '\0';
+      return size;
+    }
+  }
+
+}  // namespace troll
@@ -8,36 +8,381 @@
 
 #pragma once
 
+#include <limits>
+#include <tuple>
+#include <etl/span.h>
 #include <etl/to_arithmetic.h>
+#include <etl/vector.h>
 #include "format.hpp"
+#include "format_scan_float.hpp"
+
+// vectorized character scanning, which can be turned off by defining TROLL_NO_SIMD.
+#if !defined(TROLL_NO_SIMD)
+#if defined(__SSE2__)
+#define TROLL_SCAN_SSE2
+#if defined(__SSSE3__)
+#define TROLL_SCAN_SSSE3
+#endif  // __SSSE3__
+#if defined(__AVX2__)
+#define TROLL_SCAN_AVX2
+#endif  // __AVX2__
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define TROLL_SCAN_NEON
+#include <arm_neon.h>
+#endif
+#endif  // TROLL_NO_SIMD
+
+// std::string_view captures are only available on hosted builds.
+#if __STDC_HOSTED__ && __has_include(<string_view>)
+#define TROLL_SCAN_STD_STRING_VIEW
+#include <string_view>
+#endif
 
 namespace troll {
 
-  constexpr bool is_digit(char c) noexcept {
-    return c >= '0' && c <= '9';
+  // The built-in character classes are function objects instead of functions, so that
+  // `eat_while` can tell them apart and scan blocks of bytes at a time.
+
+  struct is_digit_t {
+    constexpr bool operator()(char c) const noexcept {
+      return c >= '0' && c <= '9';
+    }
+  };
+
+  struct is_white_space_t {
+    constexpr bool operator()(char c) const noexcept {
+      return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+  };
+
+  struct is_non_white_space_t {
+    constexpr bool operator()(char c) const noexcept {
+      return !is_white_space_t{}(c);
+    }
+  };
+
+  static constexpr is_digit_t is_digit{};
+  static constexpr is_white_space_t is_white_space{};
+  static constexpr is_non_white_space_t is_non_white_space{};
+
+  /**
+   * A set of characters from a scanf-style class, such as `[A-Za-z0-9_]` or `[^,]`, kept as a
+   * 256-bit bitmap. nul is never in the set. The bitmap is also laid out as two tables indexed by
+   * the low 4 bits of a character, so that `eat_while` can look up blocks of bytes with a byte
+   * shuffle where the target has one.
+   */
+  class scan_set {
+  public:
+    // Constructor. The set is empty.
+    constexpr scan_set() noexcept = default;
+
+    /**
+     * Returns the length of the class at the start of spec (see `parse`), including the
+     * brackets, or 0 if it is not closed.
+     */
+    static constexpr size_t spec_len(const char *spec) noexcept {
+      if (spec[0] != '[') {
+        return 0;
+      }
+      size_t i = 1;
+      i += spec[i] == '^';
+      for (size_t first = i; spec[i] && (spec[i] != ']' || i == first); ++i) {
+        if (spec[i + 1] == '-' && spec[i + 2] && spec[i + 2] != ']') {
+          i += 2;
+        }
+      }
+      return spec[i] == ']' ? i + 1 : 0;
+    }
+
+    /**
+     * Parses the class at the start of spec, which must start with `[`. `^` right after `[`
+     * takes the complement, `]` right after `[` or `[^` is part of the set, and `-` between two
+     * characters makes a range.
+     *
+     * Returns the length of the class including the brackets, or 0 if it is not closed.
+     */
+    constexpr size_t parse(const char *spec) noexcept {
+      *this = scan_set{};
+      if (spec[0] != '[') {
+        return 0;
+      }
+      size_t i = 1;
+      bool negate = spec[i] == '^';
+      i += negate;
+      for (size_t first = i; spec[i] && (spec[i] != ']' || i == first); ++i) {
+        unsigned lo = static_cast<unsigned char>(spec[i]), hi = lo;
+        if (spec[i + 1] == '-' && spec[i + 2] && spec[i + 2] != ']') {
+          hi = static_cast<unsigned char>(spec[i + 2]);
+          i += 2;
+        }
+        for (unsigned c = lo; c <= hi; ++c) {
+          bits_[c / 64] |= uint64_t(1) << (c % 64);
+        }
+      }
+      if (spec[i] != ']') {
+        *this = scan_set{};
+        return 0;
+      }
+      for (auto &word : bits_) {
+        word = negate ? ~word : word;
+      }
+      bits_[0] &= ~uint64_t(1);
+      for (unsigned c = 0; c < 256; ++c) {
+        if (contains_(c)) {
+          (c < 128 ? low_rows_ : high_rows_)[c & 15] |= uint8_t(1 << (c >> 4 & 7));
+        }
+      }
+      return i + 1;
+    }
+
+    constexpr bool operator()(char c) const noexcept {
+      return contains_(static_cast<unsigned char>(c));
+    }
+
+    // for every low nibble, which of the high nibbles 0-7 and 8-15 are in the set.
+    uint8_t low_rows_[16] {}, high_rows_[16] {};
+
+  private:
+    constexpr bool contains_(unsigned c) const noexcept {
+      return bits_[c / 64] >> (c % 64) & 1;
+    }
+
+    uint64_t bits_[4] {};
+  };
+
+  // swar: every byte of a uint64_t is one character, and the high bit of each byte is the result.
+  static constexpr uint64_t swar_ones_ = ~uint64_t(0) / 255;
+  static constexpr uint64_t swar_lows_ = swar_ones_ * 0x7f;
+  static constexpr uint64_t swar_highs_ = swar_ones_ * 0x80;
+
+  constexpr uint64_t swar_eq_(uint64_t v, char c) noexcept {
+    uint64_t x = v ^ (swar_ones_ * static_cast<unsigned char>(c));
+    // no carry crosses bytes since each byte is at most 0x7f + 0x7f
+    return ~(((x & swar_lows_) + swar_lows_) | x) & swar_highs_;
+  }
+
+  constexpr uint64_t swar_matches_(uint64_t v, is_digit_t) noexcept {
+    uint64_t y = v & swar_lows_;
+    uint64_t ge_0 = y + swar_ones_ * (0x80 - '0');
+    uint64_t ge_10 = y + swar_ones_ * (0x80 - '9' - 1);
+    return ge_0 & ~ge_10 & ~v & swar_highs_;
+  }
+
+  constexpr uint64_t swar_matches_(uint64_t v, is_white_space_t) noexcept {
+    return swar_eq_(v, ' ') | swar_eq_(v, '\t') | swar_eq_(v, '\r') | swar_eq_(v, '\n');
+  }
+
+  constexpr uint64_t swar_matches_(uint64_t v, is_non_white_space_t) noexcept {
+    // eat_while also stops at nul
+    return ~(swar_matches_(v, is_white_space) | swar_eq_(v, '\0')) & swar_highs_;
+  }
+
+#if defined(TROLL_SCAN_SSE2)
+  inline __m128i simd_matches_(__m128i v, is_digit_t) noexcept {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+  }
+
+  inline __m128i simd_matches_(__m128i v, is_white_space_t) noexcept {
+    return _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')))
+    );
+  }
+
+  inline __m128i simd_matches_(__m128i v, is_non_white_space_t) noexcept {
+    __m128i stops = _mm_or_si128(simd_matches_(v, is_white_space), _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+    return _mm_xor_si128(stops, _mm_set1_epi8(-1));
+  }
+#endif  // TROLL_SCAN_SSE2
+
+#if defined(TROLL_SCAN_AVX2)
+  inline __m256i simd_matches_(__m256i v, is_digit_t) noexcept {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+  }
+
+  inline __m256i simd_matches_(__m256i v, is_white_space_t) noexcept {
+    return _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')))
+    );
+  }
+
+  inline __m256i simd_matches_(__m256i v, is_non_white_space_t) noexcept {
+    __m256i stops = _mm256_or_si256(simd_matches_(v, is_white_space), _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+    return _mm256_xor_si256(stops, _mm256_set1_epi8(-1));
+  }
+#endif  // TROLL_SCAN_AVX2
+
+#if defined(TROLL_SCAN_NEON)
+  inline uint8x16_t simd_matches_(uint8x16_t v, is_digit_t) noexcept {
+    return vcleq_u8(vsubq_u8(v, vdupq_n_u8('0')), vdupq_n_u8(9));
+  }
+
+  inline uint8x16_t simd_matches_(uint8x16_t v, is_white_space_t) noexcept {
+    return vorrq_u8(
+      vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), vceqq_u8(v, vdupq_n_u8('\t'))),
+      vorrq_u8(vceqq_u8(v, vdupq_n_u8('\r')), vceqq_u8(v, vdupq_n_u8('\n')))
+    );
+  }
+
+  inline uint8x16_t simd_matches_(uint8x16_t v, is_non_white_space_t) noexcept {
+    return vmvnq_u8(vorrq_u8(simd_matches_(v, is_white_space), vceqq_u8(v, vdupq_n_u8(0))));
+  }
+#endif  // TROLL_SCAN_NEON
+
+#if defined(TROLL_SCAN_SSSE3)
+  inline __m128i simd_matches_(__m128i v, const scan_set &set) noexcept {
+    __m128i nibble = _mm_set1_epi8(15);
+    __m128i lo = _mm_and_si128(v, nibble);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+    __m128i low_rows = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(set.low_rows_)), lo);
+    __m128i high_rows = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(set.high_rows_)), lo);
+    __m128i high = _mm_cmpgt_epi8(hi, _mm_set1_epi8(7));
+    __m128i rows = _mm_or_si128(_mm_and_si128(high, high_rows), _mm_andnot_si128(high, low_rows));
+    __m128i bit = _mm_shuffle_epi8(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128), hi);
+    return _mm_xor_si128(_mm_cmpeq_epi8(_mm_and_si128(rows, bit), _mm_setzero_si128()), _mm_set1_epi8(-1));
+  }
+#endif  // TROLL_SCAN_SSSE3
+
+#if defined(TROLL_SCAN_AVX2)
+  inline __m256i simd_matches_(__m256i v, const scan_set &set) noexcept {
+    __m256i nibble = _mm256_set1_epi8(15);
+    __m256i lo = _mm256_and_si256(v, nibble);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+    __m256i low_rows = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(set.low_rows_))), lo);
+    __m256i high_rows = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(set.high_rows_))), lo);
+    __m256i rows = _mm256_blendv_epi8(low_rows, high_rows, _mm256_cmpgt_epi8(hi, _mm256_set1_epi8(7)));
+    __m256i bit = _mm256_shuffle_epi8(_mm256_setr_epi8(
+      1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+      1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128
+    ), hi);
+    return _mm256_xor_si256(_mm256_cmpeq_epi8(_mm256_and_si256(rows, bit), _mm256_setzero_si256()), _mm256_set1_epi8(-1));
+  }
+#endif  // TROLL_SCAN_AVX2
+
+#if defined(TROLL_SCAN_NEON)
+  inline uint8x16_t simd_matches_(uint8x16_t v, const scan_set &set) noexcept {
+    uint8x16_t lo = vandq_u8(v, vdupq_n_u8(15));
+    uint8x16_t hi = vshrq_n_u8(v, 4);
+    uint8x16_t low_rows = vqtbl1q_u8(vld1q_u8(set.low_rows_), lo);
+    uint8x16_t high_rows = vqtbl1q_u8(vld1q_u8(set.high_rows_), lo);
+    uint8x16_t rows = vbslq_u8(vcgtq_u8(hi, vdupq_n_u8(7)), high_rows, low_rows);
+    static constexpr uint8_t bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t bit = vqtbl1q_u8(vld1q_u8(bits), hi);
+    return vtstq_u8(rows, bit);
   }
+#endif  // TROLL_SCAN_NEON
 
-  constexpr bool is_white_space(char c) noexcept {
-    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+  /**
+   * Returns the number of leading characters in the set, scanning 16 or 32 bytes at a time with
+   * a byte shuffle if the target has one (SSSE3, AVX2 or NEON). It stops at the first character
+   * not in the set or before the last incomplete block, whichever comes first.
+   */
+  inline size_t eat_set_blocks(const char *test, size_t test_len, const scan_set &set) noexcept {
+    (void)set;
+    size_t i = 0;
+#if defined(TROLL_SCAN_AVX2)
+    for (; test_len - i >= 32; i += 32) {
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(test + i));
+      if (uint32_t stops = ~static_cast<uint32_t>(_mm256_movemask_epi8(simd_matches_(v, set)))) {
+        return i + __builtin_ctz(stops);
+      }
+    }
+#endif  // TROLL_SCAN_AVX2
+#if defined(TROLL_SCAN_SSSE3)
+    for (; test_len - i >= 16; i += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(test + i));
+      if (uint32_t stops = ~static_cast<uint32_t>(_mm_movemask_epi8(simd_matches_(v, set))) & 0xffff) {
+        return i + __builtin_ctz(stops);
+      }
+    }
+#elif defined(TROLL_SCAN_NEON)
+    for (; test_len - i >= 16; i += 16) {
+      uint8x16_t m = simd_matches_(vld1q_u8(reinterpret_cast<const uint8_t *>(test + i)), set);
+      uint64_t matches = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+      if (uint64_t stops = ~matches) {
+        return i + __builtin_ctzll(stops) / 4;
+      }
+    }
+#endif  // TROLL_SCAN_SSSE3 || TROLL_SCAN_NEON
+    (void)test;
+    (void)test_len;
+    return i;
   }
 
-  constexpr bool is_non_white_space(char c) noexcept {
-    return !is_white_space(c);
+  /**
+   * Returns the number of leading characters in a built-in character class, scanning as many
+   * bytes as possible at a time. It stops at the first character not in the class or at least 8
+   * characters before test_len, whichever comes first.
+   */
+  template<class Class>
+  inline size_t eat_class_blocks(const char *test, size_t test_len, Class cls) noexcept {
+    (void)cls;
+    size_t i = 0;
+#if defined(TROLL_SCAN_AVX2)
+    for (; test_len - i >= 32; i += 32) {
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(test + i));
+      if (uint32_t stops = ~static_cast<uint32_t>(_mm256_movemask_epi8(simd_matches_(v, cls)))) {
+        return i + __builtin_ctz(stops);
+      }
+    }
+#endif  // TROLL_SCAN_AVX2
+#if defined(TROLL_SCAN_SSE2)
+    for (; test_len - i >= 16; i += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(test + i));
+      if (uint32_t stops = ~static_cast<uint32_t>(_mm_movemask_epi8(simd_matches_(v, cls))) & 0xffff) {
+        return i + __builtin_ctz(stops);
+      }
+    }
+#elif defined(TROLL_SCAN_NEON)
+    for (; test_len - i >= 16; i += 16) {
+      uint8x16_t m = simd_matches_(vld1q_u8(reinterpret_cast<const uint8_t *>(test + i)), cls);
+      // narrow every byte of the mask to 4 bits
+      uint64_t matches = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+      if (uint64_t stops = ~matches) {
+        return i + __builtin_ctzll(stops) / 4;
+      }
+    }
+#endif  // TROLL_SCAN_SSE2 || TROLL_SCAN_NEON
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (; test_len - i >= 8; i += 8) {
+      uint64_t v;
+      __builtin_memcpy(&v, test + i, 8);
+      if (uint64_t stops = ~swar_matches_(v, cls) & swar_highs_) {
+        return i + __builtin_ctzll(stops) / 8;
+      }
+    }
+#endif  // little endian
+    return i;
   }
 
+  /**
+   * Returns the number of leading characters for which f returns true, stopping at nul or
+   * test_len. For the built-in `is_digit`, `is_white_space` and `is_non_white_space`, and for a
+   * `scan_set`, bytes are scanned in blocks. A test_len of `-1` means the string is only bounded
+   * by its nul, and then it is always scanned byte by byte.
+   */
   template<class F>
   constexpr size_t eat_while(const char *test, size_t test_len, F &&f) noexcept {
+    using Decay = std::decay_t<F>;
     size_t i = 0;
-    while (test_len-- && test[i]) {
-      if (!f(test[i])) {
-        break;
+    if constexpr (std::is_same_v<Decay, is_digit_t> || std::is_same_v<Decay, is_white_space_t> || std::is_same_v<Decay, is_non_white_space_t>) {
+      if (!__builtin_is_constant_evaluated() && test_len != size_t(-1)) {
+        i = eat_class_blocks(test, test_len, f);
+      }
+    } else if constexpr (std::is_same_v<Decay, scan_set>) {
+      if (!__builtin_is_constant_evaluated() && test_len != size_t(-1)) {
+        i = eat_set_blocks(test, test_len, f);
       }
-      ++i;
     }
+    for (; i < test_len && test[i] && f(test[i]); ++i) {}
     return i;
   }
 
   static constexpr auto sscan_eats_white_space = true;
+  // the longest value other than a string that `sscan_stream` buffers by default
+  static constexpr size_t sscan_stream_token_len = 64;
 
   struct unsupported_from_string_type {};
 
@@ -47,6 +392,53 @@ namespace troll {
     unsupported_from_string_type operator()(::etl::string_view, TT) const;
   };
 
+  /**
+   * Returns the length of the placeholder at the start of the format string (`{}`, `{...}` for
+   * a list, `{[...]}` for a scanset or `{:x}`, `{:b}`, `{:o}`, `{:i}` for an integer in another
+   * base), or 0 if there is none.
+   */
+  constexpr inline size_t sscan_placeholder_len(const char *format) noexcept {
+    if (format[0] != '{') {
+      return 0;
+    }
+    if (format[1] == '}') {
+      return 2;
+    }
+    if (format[1] == ':' && (format[2] == 'x' || format[2] == 'b' || format[2] == 'o' || format[2] == 'i') && format[3] == '}') {
+      return 4;
+    }
+    if (format[1] == '.' && format[2] == '.' && format[3] == '.' && format[4] == '}') {
+      return 5;
+    }
+    if (size_t set = scan_set::spec_len(format + 1); set && format[set + 1] == '}') {
+      return set + 2;
+    }
+    return 0;
+  }
+
+  /**
+   * Returns the base of the integer captured by the placeholder at the start of the format
+   * string: 16 for `{:x}`, 2 for `{:b}`, 8 for `{:o}`, 0 (detected from the prefix) for `{:i}`,
+   * and 10 otherwise.
+   */
+  constexpr inline unsigned sscan_placeholder_base(const char *format) noexcept {
+    if (format[0] != '{' || format[1] != ':') {
+      return 10;
+    }
+    switch (format[2]) {
+    case 'x':
+      return 16;
+    case 'b':
+      return 2;
+    case 'o':
+      return 8;
+    case 'i':
+      return 0;
+    default:
+      return 10;
+    }
+  }
+
   struct sscan_impl_ret {
     bool success;
     size_t test_remain {};
@@ -83,6 +475,431 @@ namespace troll {
     }
   }
 
+  /**
+   * Parses a decimal integer, with a leading `-` if the type is signed, from the start of the
+   * input string. Digits are accumulated as they are scanned, so every character is read once.
+   *
+   * Returns the number of consumed characters, or 0 if there are no digits or the value does not
+   * fit in the type.
+   */
+  template<class T>
+  constexpr inline size_t sscan_integer(const char *test, size_t test_len, T &value) noexcept {
+#if defined(TROLL_STD_CHARCONV)
+    if (!__builtin_is_constant_evaluated()) {
+      auto r = std::from_chars(test, test + test_len, value);
+      return r.ec == std::errc() ? size_t(r.ptr - test) : 0;
+    }
+#endif  // TROLL_STD_CHARCONV
+    using U = std::make_unsigned_t<T>;
+    size_t i = 0;
+    bool neg = false;
+    if constexpr (std::is_signed_v<T>) {
+      neg = test_len && *test == '-';
+      i = neg;
+    }
+    size_t start = i;
+    U v = 0;
+    bool overflow = false;
+    for (; i < test_len; ++i) {
+      unsigned d = static_cast<unsigned char>(test[i]) - unsigned('0');
+      if (d > 9) {
+        break;
+      }
+      overflow |= __builtin_mul_overflow(v, U(10), &v);
+      overflow |= __builtin_add_overflow(v, U(d), &v);
+    }
+    if constexpr (std::is_signed_v<T>) {
+      // the magnitude of a negative value may be one more than the maximum
+      overflow |= v > U(std::numeric_limits<T>::max()) + U(neg);
+    }
+    if (i == start || overflow) {
+      return 0;
+    }
+    value = neg ? T(U(0) - v) : T(v);
+    return i;
+  }
+
+  // the value of every character as a digit, or 0xff if it is not one
+  struct scan_digit_table_ {
+    uint8_t values[256];
+
+    constexpr scan_digit_table_() noexcept : values{} {
+      for (size_t c = 0; c < 256; ++c) {
+        values[c] = 0xff;
+      }
+      for (size_t d = 0; d < 10; ++d) {
+        values['0' + d] = uint8_t(d);
+      }
+      for (size_t d = 0; d < 26; ++d) {
+        values['a' + d] = values['A' + d] = uint8_t(10 + d);
+      }
+    }
+  };
+
+  inline constexpr scan_digit_table_ scan_digit_values_ {};
+
+  // accumulates digits of the base and returns how many there are.
+  template<unsigned Base, class U>
+  constexpr inline size_t scan_magnitude_(const char *test, size_t test_len, U &v, bool &overflow) noexcept {
+    size_t i = 0;
+    for (; i < test_len; ++i) {
+      unsigned d = scan_digit_values_.values[static_cast<unsigned char>(test[i])];
+      if (d >= Base) {
+        break;
+      }
+      overflow |= __builtin_mul_overflow(v, U(Base), &v);
+      overflow |= __builtin_add_overflow(v, U(d), &v);
+    }
+    return i;
+  }
+
+  /**
+   * Parses an integer in the base (2, 8, 10 or 16), with a leading `-` if the type is signed,
+   * from the start of the input string. Base 16 may be prefixed by `0x` and base 2 by `0b`. Base
+   * 0 detects it from the prefix like `strtol`: `0x` is hexadecimal, `0b` is binary, another
+   * leading `0` is octal and anything else is decimal. A prefix without digits after it is not
+   * consumed, so `0x` alone is read as 0.
+   *
+   * Returns the number of consumed characters, or 0 if there are no digits, the value does not
+   * fit in the type or the base is not supported.
+   */
+  template<class T>
+  constexpr inline size_t sscan_integer(const char *test, size_t test_len, T &value, unsigned base) noexcept {
+    if (base == 10) {
+      return sscan_integer(test, test_len, value);
+    }
+    using U = std::make_unsigned_t<T>;
+    size_t i = 0;
+    bool neg = false;
+    if constexpr (std::is_signed_v<T>) {
+      neg = test_len && *test == '-';
+      i = neg;
+    }
+    bool zero = i < test_len && test[i] == '0';
+    char prefix = zero && i + 1 < test_len ? char(test[i + 1] | 0x20) : '\0';
+    size_t skip = 0;
+    if (prefix == 'x' && (base == 16 || base == 0)) {
+      base = 16;
+      skip = 2;
+    } else if (prefix == 'b' && (base == 2 || base == 0)) {
+      base = 2;
+      skip = 2;
+    } else if (base == 0) {
+      base = zero ? 8 : 10;
+    }
+    U v = 0;
+    bool overflow = false;
+    size_t digits = 0;
+    switch (base) {
+    case 2:
+      digits = scan_magnitude_<2>(test + i + skip, test_len - i - skip, v, overflow);
+      break;
+    case 8:
+      digits = scan_magnitude_<8>(test + i + skip, test_len - i - skip, v, overflow);
+      break;
+    case 10:
+      digits = scan_magnitude_<10>(test + i + skip, test_len - i - skip, v, overflow);
+      break;
+    case 16:
+      digits = scan_magnitude_<16>(test + i + skip, test_len - i - skip, v, overflow);
+      break;
+    default:
+      return 0;
+    }
+    if (skip && !digits) {
+      // only the 0 of the prefix
+      skip = 0;
+      digits = 1;
+    } else if (!digits) {
+      return 0;
+    }
+    if constexpr (std::is_signed_v<T>) {
+      overflow |= v > U(std::numeric_limits<T>::max()) + U(neg);
+    }
+    if (overflow) {
+      return 0;
+    }
+    value = neg ? T(U(0) - v) : T(v);
+    return i + skip + digits;
+  }
+
+  template<class T>
+  struct is_scan_integer : std::bool_constant<
+    std::is_integral_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, unsigned char> && !std::is_same_v<T, bool>
+  > {};
+
+  /**
+   * Parses a decimal number with an optional sign and fractional part, such as `-1.25`, `3.` or
+   * `.5`, into the scaled integer of the fixed-point number. Digits beyond what the scale can
+   * hold are rounded by the rounding of the type. Only integer arithmetic is used.
+   *
+   * Returns the number of consumed characters, or 0 if there are no digits or the value does
+   * not fit.
+   */
+  template<uint64_t Scale, unsigned Precision, fixed_rounding Rounding>
+  constexpr inline size_t sscan_fixed(const char *test, size_t test_len, fixed<Scale, Precision, Rounding> &f) noexcept {
+    // the most fractional digits whose scaled value cannot overflow
+    constexpr unsigned max_frac = [] {
+      unsigned n = 0;
+      while (n < 19 && pow10_(n + 1) <= UINT64_MAX / 2 / Scale) ++n;
+      return n;
+    }();
+    size_t i = test_len && (*test == '-' || *test == '+');
+    bool neg = i && *test == '-';
+    uint64_t whole = 0;
+    bool overflow = false;
+    size_t digits = scan_magnitude_<10>(test + i, test_len - i, whole, overflow);
+    i += digits;
+    uint64_t frac = 0;
+    unsigned frac_digits = 0;
+    if (i < test_len && test[i] == '.') {
+      size_t j = i + 1;
+      for (; j < test_len && is_digit(test[j]); ++j) {
+        if (frac_digits < max_frac) {
+          frac = frac * 10 + unsigned(test[j] - '0');
+          ++frac_digits;
+        }
+      }
+      if (digits || j > i + 1) {
+        digits += j - i - 1;
+        i = j;
+      }
+    }
+    if (!digits) {
+      return 0;
+    }
+    uint64_t num = frac * Scale, den = pow10_(frac_digits);
+    uint64_t scaled = num / den;
+    if (Rounding == fixed_rounding::nearest && num % den * 2 >= den) {
+      ++scaled;
+    }
+    uint64_t mag = 0;
+    overflow |= __builtin_mul_overflow(whole, Scale, &mag);
+    overflow |= __builtin_add_overflow(mag, scaled, &mag);
+    overflow |= mag > uint64_t(INT64_MAX) + neg;
+    if (overflow) {
+      return 0;
+    }
+    f.value = neg ? int64_t(0 - mag) : int64_t(mag);
+    return i;
+  }
+
+  template<class T, class = void>
+  struct is_scan_vector : std::false_type {};
+
+  template<class T>
+  struct is_scan_vector<T, std::void_t<typename T::value_type>> : std::is_base_of<::etl::ivector<typename T::value_type>, T> {};
+
+  /**
+   * A span for a list to be scanned into, and the number of elements that were parsed into the
+   * front of it. The span itself is left as it is.
+   */
+  template<class T>
+  struct scan_span {
+    ::etl::span<T> elems;
+    size_t size = 0;
+  };
+
+  template<class T>
+  struct is_scan_span : std::false_type {};
+
+  template<class T>
+  struct is_scan_span<scan_span<T>> : std::true_type {};
+
+  template<class T>
+  struct is_scan_list : std::bool_constant<is_scan_vector<T>::value || is_scan_span<T>::value> {};
+
+  template<class Arg>
+  constexpr inline size_t sscan_value(const char *test, size_t test_len, Arg &arg) noexcept;
+
+  /**
+   * Parses values of the element type of the list, separated by white space, from the start of
+   * the input string until one cannot be parsed, the input ends or the list is full. An
+   * `etl::vector` is cleared first and then appended to, and the span of a `scan_span` is filled
+   * from the front, with the number of parsed elements in its `size`.
+   *
+   * Returns the number of consumed characters up to the end of the last element, or 0 if there
+   * is no element.
+   */
+  template<class List>
+  constexpr inline size_t sscan_list(const char *test, size_t test_len, List &list) noexcept {
+    size_t count = 0, capacity = 0;
+    if constexpr (is_scan_vector<List>::value) {
+      list.clear();
+      capacity = list.max_size();
+    } else {
+      capacity = list.elems.size();
+    }
+    size_t end = 0;
+    while (count < capacity) {
+      size_t i = end;
+      if (count) {
+        i += eat_while(test + i, test_len - i, is_white_space);
+      }
+      if (i == test_len) {
+        break;
+      }
+      size_t n = 0;
+      if constexpr (is_scan_vector<List>::value) {
+        // parse in place, and take it back if it fails
+        list.emplace_back();
+        n = sscan_value(test + i, test_len - i, list.back());
+        if (!n) {
+          list.pop_back();
+        }
+      } else {
+        n = sscan_value(test + i, test_len - i, list.elems[count]);
+      }
+      if (!n) {
+        break;
+      }
+      ++count;
+      end = i + n;
+    }
+    if constexpr (is_scan_span<List>::value) {
+      list.size = count;
+    }
+    return end;
+  }
+
+  template<class T>
+  struct is_scan_string_view : std::false_type {};
+
+  template<>
+  struct is_scan_string_view<::etl::string_view> : std::true_type {};
+
+#if defined(TROLL_SCAN_STD_STRING_VIEW)
+  template<>
+  struct is_scan_string_view<std::string_view> : std::true_type {};
+#endif
+
+  template<class T>
+  struct is_scan_string : std::bool_constant<
+    (std::is_pointer_v<T> && std::is_same_v<std::remove_pointer_t<T>, char>) || is_etl_string<T>::value || is_scan_string_view<T>::value
+      || is_std_string<T>::value
+  > {};
+
+  /**
+   * Takes the leading characters in the class (one of the built-in classes or a `scan_set`) as
+   * a token. String types get the whole token, and other types are parsed from the start of it.
+   *
+   * Returns the number of consumed characters, or 0 if the token is empty or cannot be parsed.
+   */
+  template<class Class, class Arg>
+  constexpr inline size_t sscan_token(const char *test, size_t test_len, const Class &cls, Arg &arg) noexcept {
+    using Decay = std::decay_t<Arg>;
+    size_t i = eat_while(test, test_len, cls);
+    if (!i) {
+      return 0;
+    }
+    if constexpr (std::is_pointer_v<Decay> && std::is_same_v<std::remove_pointer_t<Decay>, char>) {
+      // char *
+      // if arg is array reference, then its size is known
+      using NoRef = std::remove_reference_t<Arg>;
+      size_t safe = i;
+      if constexpr (std::is_array_v<NoRef>) {
+        safe = safe < (std::extent_v<NoRef> - 1) ? safe : (std::extent_v<NoRef> - 1);
+        arg[safe] = '\0';
+      }
+      for (size_t n = 0; n < safe; ++n) {
+        arg[n] = test[n];
+      }
+      return i;
+    } else if constexpr (is_scan_string_view<Decay>::value) {
+      // ::etl::string_view, std::string_view: points into the input instead of copying
+      arg = Decay(test, i);
+      return i;
+    } else if constexpr (is_etl_string<Decay>::value || is_std_string<Decay>::value) {
+      // ::etl::string, std::string
+      arg.assign(test, i);
+      return i;
+    } else {
+      return sscan_value(test, i, arg);
+    }
+  }
+
+  /**
+   * Parses one value of the type of the variable reference from the start of the input string,
+   * and writes it down to the variable. String views are pointed into the input string without
+   * copying, so they are only valid as long as the input is.
+   *
+   * Returns the number of consumed characters, or 0 if the value cannot be parsed.
+   */
+  template<class Arg>
+  constexpr inline size_t sscan_value(const char *test, size_t test_len, Arg &arg) noexcept {
+    using Decay = std::decay_t<Arg>;
+    constexpr bool custom = !std::is_same_v<decltype(from_stringer<Decay>{}(std::declval<::etl::string_view>(), arg)), unsupported_from_string_type>;
+    if constexpr (custom) {
+      // custom type
+      return from_stringer<Decay>{}(::etl::string_view(test, test_len), arg);
+    } else if constexpr (is_scan_integer<Decay>::value) {
+      // int, uint, ...
+      return sscan_integer(test, test_len, arg);
+    } else if constexpr (std::is_same_v<Decay, bool>) {
+      // bool
+      size_t i = eat_while(test, test_len, is_digit);
+      auto result = ::etl::to_arithmetic<Decay>(::etl::string_view(test, i));
+      if (result) {
+        arg = result.value();
+        return i;
+      }
+      return 0;
+    } else if constexpr (std::is_same_v<Decay, char> || std::is_same_v<Decay, unsigned char>) {
+      // char
+      if (test_len) {
+        arg = *test;
+        return 1;
+      }
+      return 0;
+    } else if constexpr (is_fixed<Decay>::value) {
+      // fixed, decimal
+      return sscan_fixed(test, test_len, arg);
+    } else if constexpr (is_scan_list<Decay>::value) {
+      // ::etl::vector, scan_span
+      return sscan_list(test, test_len, arg);
+    } else if constexpr (is_scan_string<Decay>::value) {
+      // char *, ::etl::string, std::string, string views
+      return sscan_token(test, test_len, is_non_white_space, arg);
+    } else if constexpr (std::is_same_v<Decay, float> || std::is_same_v<Decay, double>) {
+      // float, double
+      return sscan_float(test, test_len, arg);
+#if defined(TROLL_STD_CHARCONV) && defined(__cpp_lib_to_chars)
+    } else if constexpr (std::is_floating_point_v<Decay>) {
+      // long double
+      auto r = std::from_chars(test, test + test_len, arg);
+      return r.ec == std::errc() ? size_t(r.ptr - test) : 0;
+#endif  // TROLL_STD_CHARCONV
+    } else if constexpr (std::is_floating_point_v<Decay>) {
+      // long double
+      // note: it can only be parsed when it is not surrounded by other nws characters
+      size_t i = eat_while(test, test_len, is_non_white_space);
+      if (i) {
+        auto result = ::etl::to_arithmetic<Decay>(::etl::string_view(test, i));
+        if (result) {
+          arg = result.value();
+          return i;
+        }
+      }
+      return 0;
+    } else {
+      static_assert(custom, "unsupported type");
+      return 0;
+    }
+  }
+
+  /**
+   * Same as above, but integers are parsed in the base (see `sscan_integer`). Other types ignore
+   * the base.
+   */
+  template<class Arg>
+  constexpr inline size_t sscan_value(const char *test, size_t test_len, Arg &arg, unsigned base) noexcept {
+    if constexpr (is_scan_integer<std::decay_t<Arg>>::value) {
+      return sscan_integer(test, test_len, arg, base);
+    } else {
+      return sscan_value(test, test_len, arg);
+    }
+  }
+
   template<bool Prefix, class Arg0, class ...Args>
   constexpr inline sscan_impl_ret sscan_impl(const char *test, size_t test_len, const char *format, Arg0 &arg0, Args &...args) noexcept {
     while (*format && test_len) {
@@ -96,82 +913,19 @@ namespace troll {
         }
       }
 
-      if (*format == '{' && format[1] == '}') {
-        using Decay = std::decay_t<Arg0>;
-        constexpr bool custom = !std::is_same_v<decltype(from_stringer<Decay>{}(std::declval<::etl::string_view>(), arg0)), unsupported_from_string_type>;
-        if constexpr (custom) {
-          // custom type
-          if (size_t i = from_stringer<Decay>{}(::etl::string_view(test, test_len), arg0)) {
-            return sscan_impl<Prefix>(test + i, test_len - i, format + 2, args...);
-          } else {
-            return {false};
-          }
-        } else if constexpr (std::is_integral_v<Decay> && !std::is_same_v<Decay, char> && !std::is_same_v<Decay, unsigned char>) {
-          // int, uint, ...
-          size_t i{};
-          if (std::is_signed_v<Decay> && test_len && *test == '-') {
-            i = 1 + eat_while(test + 1, test_len - 1, is_digit);
-          } else {
-            i = eat_while(test, test_len, is_digit);
-          }
-          auto result = ::etl::to_arithmetic<Decay>(::etl::string_view(test, i));
-          if (result) {
-            arg0 = result.value();
-            return sscan_impl<Prefix>(test + i, test_len - i, format + 2, args...);
-          } else {
-            return {false};
-          }
-        } else if constexpr (std::is_same_v<Decay, char> || std::is_same_v<Decay, unsigned char>) {
-          // char
-          if (test_len) {
-            arg0 = *test++;
-            return sscan_impl<Prefix>(test + 1, test_len - 1, format + 2, args...);
-          } else {
-            return {false};
-          }
-        } else if constexpr (std::is_pointer_v<Decay> && std::is_same_v<std::remove_pointer_t<Decay>, char>) {
-          // char *
-          size_t i = eat_while(test, test_len, is_non_white_space);
-          if (i) {
-            // if arg0 is array reference, then its size is known
-            using NoRef = std::remove_reference_t<Arg0>;
-            size_t safe = i;
-            if constexpr (std::is_array_v<NoRef>) {
-              safe = safe < (std::extent_v<NoRef> - 1) ? safe : (std::extent_v<NoRef> - 1);
-              arg0[safe] = '\0';
-            }
-            for (size_t n = 0; n < safe; ++n) {
-              arg0[n] = test[n];
-            }
-            return sscan_impl<Prefix>(test + i, test_len - i, format + 2, args...);
-          } else {
-            return {false};
-          }
-        } else if constexpr (is_etl_string<Decay>::value) {
-          // ::etl::string
-          size_t i = eat_while(test, test_len, is_non_white_space);
-          if (i) {
-            arg0.assign(test, i);
-            return sscan_impl<Prefix>(test + i, test_len - i, format + 2, args...);
-          } else {
-            return {false};
-          }
-        } else if constexpr (std::is_floating_point_v<Decay>) {
-          // note: floats can only be parsed when it is not surrounded by other nws characters
-          size_t i = eat_while(test, test_len, is_non_white_space);
-          if (i) {
-            auto result = ::etl::to_arithmetic<Decay>(::etl::string_view(test, i));
-            if (result) {
-              arg0 = result.value();
-              return sscan_impl<Prefix>(test + i, test_len - i, format + 2, args...);
-            } else {
-              return {false};
-            }
-          } else {
-            return {false};
-          }
+      if (size_t placeholder = sscan_placeholder_len(format)) {
+        size_t i = 0;
+        if (format[1] == '[') {
+          scan_set set;
+          set.parse(format + 1);
+          i = sscan_token(test, test_len, set, arg0);
+        } else {
+          i = sscan_value(test, test_len, arg0, sscan_placeholder_base(format));
+        }
+        if (i) {
+          return sscan_impl<Prefix>(test + i, test_len - i, format + placeholder, args...);
         } else {
-          static_assert(custom, "unsupported type");
+          return {false};
         }
       }
       if (*format++ != *test++) {
@@ -192,18 +946,279 @@ namespace troll {
     }
   }
 
+  template<size_t N, size_t Sets, size_t TokenLen, class ...Args>
+  class sscan_stream;
+
+  // the number of scanset placeholders in the format string.
+  constexpr inline size_t sscan_num_sets(const char *format) noexcept {
+    size_t sets = 0;
+    for (size_t b = 0; format[b];) {
+      if (size_t placeholder = sscan_placeholder_len(format + b)) {
+        sets += format[b + 1] == '[';
+        b += placeholder;
+      } else {
+        ++b;
+      }
+    }
+    return sets;
+  }
+
+  template<size_t Sets>
+  struct sscan_pattern_sets_ {
+    scan_set sets[Sets];
+  };
+
+  template<>
+  struct sscan_pattern_sets_<0> {};
+
   /**
-   * Checks the input string (test) compares the same as the format string, and writes down
-   * matched values to variable references.
-   * 
-   * Returns true if the input string matches the format string, false otherwise.
+   * A format string for `sscan` that is split up into literal segments, whitespace and
+   * placeholders when it is constructed (ideally at compile time), so that scanning does not
+   * need to interpret the format string again. Matching is the same as passing the format
+   * string itself.
+   *
+   * The first Sets scanset placeholders are compiled to bitmaps along with the pattern, and the
+   * rest are parsed again whenever they are scanned. Constructing from a string literal compiles
+   * none of them, since the number of scansets is not known from the type; use
+   * `make_sscan_pattern` to compile exactly the ones in the format string.
    */
-  template<class ...Args>
-  constexpr inline bool sscan(const char *test, size_t test_len, const char *format, Args &...args) noexcept {
-    return sscan_impl<false>(test, test_len, format, args...).success;
-  }
+  template<size_t N, size_t Sets = 0>
+  class sscan_pattern {
+    static_assert(N <= UINT16_MAX, "the format string is too long");
 
-  // this overload is not useful in practice
+  public:
+    // Constructor.
+    constexpr sscan_pattern(const char (&format)[N]) noexcept {
+      size_t i = 0;
+      while (i < N && format[i]) {
+        format_[i] = format[i];
+        ++i;
+      }
+      for (size_t b = 0; b < i;) {
+        auto &seg = segments_[num_segments_++];
+        seg.begin = uint16_t(b);
+        if (sscan_eats_white_space && is_white_space(format_[b])) {
+          seg.type = segment_type::white_space;
+          while (b < i && is_white_space(format_[b])) ++b;
+        } else if (size_t placeholder = sscan_placeholder_len(format_ + b)) {
+          seg.type = segment_type::placeholder;
+          if (format_[b + 1] == '[') {
+            if constexpr (Sets > 0) {
+              if (num_sets_ < Sets) {
+                sets_.sets[num_sets_].parse(format_ + b + 1);
+              }
+            }
+            seg.set = uint16_t(++num_sets_);
+          }
+          seg.base = uint8_t(sscan_placeholder_base(format_ + b));
+          b += placeholder;
+          ++num_placeholders_;
+        } else {
+          seg.type = segment_type::literal;
+          while (b < i && !(sscan_eats_white_space && is_white_space(format_[b])) && !sscan_placeholder_len(format_ + b)) ++b;
+        }
+        seg.len = uint16_t(b - seg.begin);
+      }
+    }
+
+    // The number of `{}` placeholders in the format string.
+    constexpr size_t num_placeholders() const noexcept {
+      return num_placeholders_;
+    }
+
+    // The format string.
+    constexpr const char *format() const noexcept {
+      return format_;
+    }
+
+    /**
+     * Writes the literal characters before the first placeholder into dest, leaving out white
+     * space if it is skipped, and returns how many there are. Every input that matches the
+     * pattern starts with these characters once white space is left out. dest needs room for N.
+     */
+    constexpr size_t prefix_key(char *dest) const noexcept {
+      size_t len = 0;
+      for (size_t seg = 0; seg < num_segments_; ++seg) {
+        auto &sg = segments_[seg];
+        if (sg.type == segment_type::placeholder) {
+          break;
+        }
+        if (sg.type == segment_type::literal) {
+          for (size_t i = 0; i < sg.len; ++i) {
+            dest[len++] = format_[sg.begin + i];
+          }
+        }
+      }
+      return len;
+    }
+
+    template<bool Prefix, class ...Args>
+    constexpr sscan_impl_ret scan_impl(const char *test, size_t test_len, Args &...args) const noexcept {
+      size_t seg = 0;
+      if (!(scan_next_(seg, test, test_len, args) && ...)) {
+        return {false};
+      }
+      // placeholders without variables are compared as is
+      if (!match_literals_(seg, test, test_len, true)) {
+        return {false};
+      }
+      if constexpr (sscan_eats_white_space) {
+        test_len -= eat_while(test, test_len, is_white_space);
+      }
+      if constexpr (Prefix) {
+        return {true, test_len};
+      } else {
+        return {!test_len};
+      }
+    }
+
+  private:
+    enum class segment_type : char {
+      literal,
+      white_space,
+      placeholder,
+    };
+
+    struct segment {
+      segment_type type = segment_type::literal;
+      // the base of integers
+      uint8_t base = 10;
+      uint16_t begin = 0, len = 0;
+      // 1 + the index of the scanset of a placeholder, or 0 if it has none
+      uint16_t set = 0;
+    };
+
+    // the scanset of a placeholder: the compiled one if there is one, otherwise it is parsed
+    // into tmp.
+    constexpr const scan_set &set_of_(const segment &sg, scan_set &tmp) const noexcept {
+      if constexpr (Sets > 0) {
+        if (sg.set <= Sets) {
+          return sets_.sets[sg.set - 1];
+        }
+      }
+      tmp.parse(format_ + sg.begin + 1);
+      return tmp;
+    }
+
+    static constexpr void skip_white_space_(const char *&test, size_t &test_len) noexcept {
+      if constexpr (sscan_eats_white_space) {
+        size_t len = eat_while(test, test_len, is_white_space);
+        test += len;
+        test_len -= len;
+      }
+    }
+
+    // matches segments up to the next placeholder or the end.
+    constexpr bool match_literals_(size_t &seg, const char *&test, size_t &test_len, bool placeholder_is_literal) const noexcept {
+      for (; seg < num_segments_; ++seg) {
+        auto &sg = segments_[seg];
+        if (sg.type == segment_type::white_space) {
+          skip_white_space_(test, test_len);
+          continue;
+        }
+        if (sg.type == segment_type::placeholder && !placeholder_is_literal) {
+          return true;
+        }
+        skip_white_space_(test, test_len);
+        const char *lit = format_ + sg.begin;
+        if (test_len >= sg.len && !__builtin_memcmp(test, lit, sg.len)) {
+          test += sg.len;
+          test_len -= sg.len;
+          continue;
+        }
+        // white space in the input may still split the literal
+        for (size_t i = 0; i < sg.len; ++i) {
+          skip_white_space_(test, test_len);
+          if (!test_len || *test != lit[i]) {
+            return false;
+          }
+          ++test;
+          --test_len;
+        }
+      }
+      return true;
+    }
+
+    template<class Arg>
+    constexpr bool scan_next_(size_t &seg, const char *&test, size_t &test_len, Arg &arg) const noexcept {
+      if (!match_literals_(seg, test, test_len, false)) {
+        return false;
+      }
+      if (seg == num_segments_) {
+        // more variables than placeholders, the rest are left alone
+        return true;
+      }
+      skip_white_space_(test, test_len);
+      if (!test_len) {
+        return false;
+      }
+      auto &sg = segments_[seg];
+      size_t i = 0;
+      if (sg.set) {
+        scan_set tmp {};
+        i = sscan_token(test, test_len, set_of_(sg, tmp), arg);
+      } else {
+        i = sscan_value(test, test_len, arg, sg.base);
+      }
+      test += i;
+      test_len -= i;
+      ++seg;
+      return i;
+    }
+
+    template<size_t, size_t, size_t, class ...>
+    friend class sscan_stream;
+
+    char format_[N + 1] {};
+    segment segments_[N ? N : 1] {};
+    sscan_pattern_sets_<Sets> sets_ {};
+    uint16_t num_segments_ = 0;
+    uint16_t num_placeholders_ = 0;
+    uint16_t num_sets_ = 0;
+  };
+
+  template<size_t N>
+  sscan_pattern(const char (&)[N]) -> sscan_pattern<N>;
+
+  /**
+   * Makes the pattern of the format string returned by the function (usually a lambda such as
+   * `[] { return "mv {[a-z]} {}"; }`), sized exactly for it and with every scanset compiled.
+   */
+  template<class F>
+  constexpr inline auto make_sscan_pattern(F f) noexcept {
+    constexpr const char *format = f();
+    constexpr size_t len = [] (const char *str) {
+      size_t n = 0;
+      while (str[n]) ++n;
+      return n;
+    }(format);
+    char copy[len + 1] {};
+    for (size_t i = 0; i < len; ++i) {
+      copy[i] = format[i];
+    }
+    return sscan_pattern<len + 1, sscan_num_sets(format)>(copy);
+  }
+
+  /**
+   * Checks the input string (test) compares the same as the format string, and writes down
+   * matched values to variable references.
+   * 
+   * Returns true if the input string matches the format string, false otherwise.
+   */
+  template<class ...Args>
+  constexpr inline bool sscan(const char *test, size_t test_len, const char *format, Args &...args) noexcept {
+#if defined(TROLL_INSTRUMENT)
+    if (!__builtin_is_constant_evaluated()) {
+      uint64_t start = instrument_now_();
+      bool success = sscan_impl<false>(test, test_len, format, args...).success;
+      instrument_scan_(format, success, instrument_now_() - start);
+      return success;
+    }
+#endif
+    return sscan_impl<false>(test, test_len, format, args...).success;
+  }
+
+  // this overload is not useful in practice
   /*template<size_t N, class ...Args>
   constexpr inline bool sscan(const char (&test)[N], const char *format, Args &...args) noexcept {
     return sscan(test, N - 1, format, args...);
@@ -226,7 +1241,15 @@ namespace troll {
    */
   template<class ...Args>
   constexpr inline size_t sscan_prefix(const char *test, size_t test_len, const char *format, Args &...args) noexcept {
+#if defined(TROLL_INSTRUMENT)
+    uint64_t start = __builtin_is_constant_evaluated() ? 0 : instrument_now_();
+#endif
     auto result = sscan_impl<true>(test, test_len, format, args...);
+#if defined(TROLL_INSTRUMENT)
+    if (!__builtin_is_constant_evaluated()) {
+      instrument_scan_(format, result.success, instrument_now_() - start);
+    }
+#endif
     return result.success ? test_len - result.test_remain : 0;
   }
 
@@ -238,4 +1261,733 @@ namespace troll {
     return sscan_prefix(test.data(), test.size(), format, args...);
   }
 
+  /**
+   * Same as `sscan`, but takes a precompiled format string.
+   */
+  template<size_t N, size_t S, class ...Args>
+  constexpr inline bool sscan(const char *test, size_t test_len, const sscan_pattern<N, S> &pattern, Args &...args) noexcept {
+#if defined(TROLL_INSTRUMENT)
+    if (!__builtin_is_constant_evaluated()) {
+      uint64_t start = instrument_now_();
+      bool success = pattern.template scan_impl<false>(test, test_len, args...).success;
+      instrument_scan_(pattern.format(), success, instrument_now_() - start);
+      return success;
+    }
+#endif
+    return pattern.template scan_impl<false>(test, test_len, args...).success;
+  }
+
+  /**
+   * Overload for the case where the size can be obtained automatically.
+  */
+  template<size_t N, size_t S, class ...Args>
+  constexpr inline bool sscan(::etl::string_view test, const sscan_pattern<N, S> &pattern, Args &...args) noexcept {
+    return sscan(test.data(), test.size(), pattern, args...);
+  }
+
+  /**
+   * Same as `sscan_prefix`, but takes a precompiled format string.
+   */
+  template<size_t N, size_t S, class ...Args>
+  constexpr inline size_t sscan_prefix(const char *test, size_t test_len, const sscan_pattern<N, S> &pattern, Args &...args) noexcept {
+#if defined(TROLL_INSTRUMENT)
+    uint64_t start = __builtin_is_constant_evaluated() ? 0 : instrument_now_();
+#endif
+    auto result = pattern.template scan_impl<true>(test, test_len, args...);
+#if defined(TROLL_INSTRUMENT)
+    if (!__builtin_is_constant_evaluated()) {
+      instrument_scan_(pattern.format(), result.success, instrument_now_() - start);
+    }
+#endif
+    return result.success ? test_len - result.test_remain : 0;
+  }
+
+  /**
+   * Overload for the case where the size can be obtained automatically.
+  */
+  template<size_t N, size_t S, class ...Args>
+  constexpr inline size_t sscan_prefix(::etl::string_view test, const sscan_pattern<N, S> &pattern, Args &...args) noexcept {
+    return sscan_prefix(test.data(), test.size(), pattern, args...);
+  }
+
+  template<class F>
+  struct scan_handler_traits_ : scan_handler_traits_<decltype(&F::operator())> {};
+
+  template<class R, class ...Args>
+  struct scan_handler_traits_<R (*)(Args...)> {
+    using args_type = std::tuple<std::decay_t<Args>...>;
+    static constexpr bool captures_by_value = !(std::is_pointer_v<std::decay_t<Args>> || ...);
+  };
+
+  template<class R, class C, class ...Args>
+  struct scan_handler_traits_<R (C::*)(Args...)> : scan_handler_traits_<R (*)(Args...)> {};
+
+  template<class R, class C, class ...Args>
+  struct scan_handler_traits_<R (C::*)(Args...) const> : scan_handler_traits_<R (*)(Args...)> {};
+
+  /**
+   * Whether the handler can be used in a `scan_case`. Its captures are held by value, so they
+   * cannot be pointers (or arrays, which decay to them), as there is nothing for them to point to.
+   */
+  template<class F>
+  static constexpr bool is_scan_handler_v = scan_handler_traits_<F>::captures_by_value;
+
+  /**
+   * A format string and the handler that receives its captured values, for `scan_dispatch`. The
+   * types of the captures are the parameter types of the handler.
+   */
+  template<size_t N, class F>
+  class scan_case {
+    static_assert(is_scan_handler_v<F>, "handler parameters are captured by value: take numbers, "
+      "chars, etl::string, etl::string_view or lists instead of pointers or arrays");
+
+  public:
+    using args_type = typename scan_handler_traits_<F>::args_type;
+    static constexpr size_t format_size = N;
+
+    // Constructor.
+    constexpr scan_case(const char (&format)[N], F handler) noexcept
+      : pattern{format}, handler{handler} {}
+
+    sscan_pattern<N> pattern;
+    F handler;
+  };
+
+  template<size_t N, class F>
+  scan_case(const char (&)[N], F) -> scan_case<N, F>;
+
+  /**
+   * Matches an input string against a list of `scan_case`s and calls the handler of the first
+   * one (in the order given) that matches, the same as trying `sscan` with each format in turn.
+   *
+   * The literal prefixes of the formats (everything before the first placeholder) are merged into
+   * a trie when the object is constructed, ideally at compile time. Dispatching walks the trie
+   * once over the input to find the formats whose prefix matches, and only scans those.
+   */
+  template<class ...Cases>
+  class scan_dispatch {
+  public:
+    static constexpr size_t num_cases = sizeof...(Cases);
+
+    // Constructor.
+    constexpr scan_dispatch(Cases ...cases) noexcept : cases_{cases...} {
+      add_cases_(std::make_index_sequence<num_cases>{});
+    }
+
+    /**
+     * Calls the handler of the first case that matches the whole input string with the
+     * captured values.
+     *
+     * Returns whether any case matched.
+     */
+    constexpr bool operator()(const char *test, size_t test_len) const {
+      mask_type candidates[num_words_] {};
+      find_candidates_(test, test_len, candidates);
+      return try_cases_(std::make_index_sequence<num_cases>{}, test, test_len, candidates);
+    }
+
+    /**
+     * Overload for the case where the size can be obtained automatically.
+     */
+    constexpr bool operator()(::etl::string_view test) const {
+      return (*this)(test.data(), test.size());
+    }
+
+  private:
+    using mask_type = uint64_t;
+    using node_index = uint16_t;
+
+    static constexpr size_t num_words_ = (num_cases + 63) / 64;
+    static constexpr size_t max_nodes_ = 1 + (Cases::format_size + ... + 0);
+    static_assert(max_nodes_ < node_index(-1), "too many format strings");
+
+    struct node {
+      char c = 0;
+      node_index first_child = 0, next_sibling = 0;
+      mask_type terminal[num_words_] {};
+    };
+
+    template<size_t ...I>
+    constexpr void add_cases_(std::index_sequence<I...>) noexcept {
+      (add_case_(I, std::get<I>(cases_).pattern), ...);
+    }
+
+    template<class Pattern>
+    constexpr void add_case_(size_t index, const Pattern &pattern) noexcept {
+      char key[sizeof(Pattern)] {};
+      size_t len = pattern.prefix_key(key);
+      node_index n = 0;
+      for (size_t i = 0; i < len; ++i) {
+        n = child_(n, key[i], true);
+      }
+      nodes_[n].terminal[index / 64] |= mask_type(1) << (index % 64);
+    }
+
+    // finds the child of the node with the character, optionally adding one. 0 is not found.
+    constexpr node_index child_(node_index n, char c, bool add = false) noexcept {
+      if (!n && root_children_[static_cast<unsigned char>(c)]) {
+        return root_children_[static_cast<unsigned char>(c)];
+      }
+      node_index *link = &nodes_[n].first_child;
+      for (; *link; link = &nodes_[*link].next_sibling) {
+        if (nodes_[*link].c == c) {
+          return *link;
+        }
+      }
+      if (!add) {
+        return 0;
+      }
+      nodes_[num_nodes_].c = c;
+      *link = node_index(num_nodes_);
+      if (!n) {
+        root_children_[static_cast<unsigned char>(c)] = node_index(num_nodes_);
+      }
+      return node_index(num_nodes_++);
+    }
+
+    constexpr node_index find_child_(node_index n, char c) const noexcept {
+      if (!n) {
+        return root_children_[static_cast<unsigned char>(c)];
+      }
+      for (node_index child = nodes_[n].first_child; child; child = nodes_[child].next_sibling) {
+        if (nodes_[child].c == c) {
+          return child;
+        }
+      }
+      return 0;
+    }
+
+    // collects every case whose prefix key is a prefix of the input with white space left out.
+    constexpr void find_candidates_(const char *test, size_t test_len, mask_type *candidates) const noexcept {
+      node_index n = 0;
+      for (size_t i = 0;; ++i) {
+        for (size_t w = 0; w < num_words_; ++w) {
+          candidates[w] |= nodes_[n].terminal[w];
+        }
+        if constexpr (sscan_eats_white_space) {
+          i += eat_while(test + i, test_len - i, is_white_space);
+        }
+        if (i >= test_len || !(n = find_child_(n, test[i]))) {
+          return;
+        }
+      }
+    }
+
+    template<size_t ...I>
+    constexpr bool try_cases_(std::index_sequence<I...>, const char *test, size_t test_len, const mask_type *candidates) const {
+      return ((candidates[I / 64] >> (I % 64) & 1 && try_case_(std::get<I>(cases_), test, test_len)) || ...);
+    }
+
+    template<class Case>
+    static constexpr bool try_case_(const Case &c, const char *test, size_t test_len) {
+      typename Case::args_type args {};
+      bool matched = std::apply([&](auto &...a) {
+        return c.pattern.template scan_impl<false>(test, test_len, a...).success;
+      }, args);
+      if (matched) {
+        std::apply(c.handler, args);
+      }
+      return matched;
+    }
+
+    std::tuple<Cases...> cases_;
+    node nodes_[max_nodes_] {};
+    size_t num_nodes_ = 1;
+    // the root has the most children, so it looks them up directly
+    node_index root_children_[256] {};
+  };
+
+  enum class scan_status : char {
+    needs_more,
+    matched,
+    failed,
+  };
+
+  /**
+   * Matches input that arrives in pieces against a precompiled format string, the same as
+   * `sscan` would match the whole input at once. The position in the format is kept across
+   * `feed` calls, and only the value currently being parsed is buffered, so a mismatch is
+   * reported as soon as the offending character arrives.
+   *
+   * Strings are written to their variables as the characters arrive and can be of any length.
+   * Other values are buffered up to TokenLen characters (`sscan_stream_token_len` unless made
+   * with `make_sscan_stream`), and a longer one fails the stream even where `sscan` would take
+   * it. Numbers are parsed once they are complete, but values of `from_stringer` types are
+   * parsed again as every character arrives, since only the parser knows where they end; a
+   * parser that does not match the buffered characters yet is asked again with the next one, so
+   * such a mismatch is only reported when the buffer is full or at `finish`.
+   *
+   * The pattern and the variables must outlive the object. String views cannot be captured,
+   * since the input they would point into is gone after `feed` returns.
+   */
+  template<size_t N, size_t Sets, size_t TokenLen, class ...Args>
+  class sscan_stream {
+    static_assert(TokenLen > 0, "values need a buffer");
+    static_assert(!(is_scan_string_view<std::decay_t<Args>>::value || ...), "string views cannot be captured from a stream");
+    static_assert(!(is_scan_list<std::decay_t<Args>>::value || ...), "lists cannot be captured from a stream");
+
+  public:
+    // Constructor.
+    constexpr sscan_stream(const sscan_pattern<N, Sets> &pattern, Args &...args) noexcept
+      : pattern_{pattern}, args_{args...} {
+      reset();
+    }
+
+    /**
+     * Starts over from the beginning of the format string.
+     */
+    constexpr void reset() noexcept {
+      seg_ = 0;
+      lit_pos_ = 0;
+      arg_ = 0;
+      token_len_ = 0;
+      status_ = scan_status::needs_more;
+      update_status_();
+    }
+
+    /**
+     * Consumes the next piece of input.
+     *
+     * Returns `failed` as soon as the input cannot match anymore, `matched` if the input so far
+     * matches the whole format string, and `needs_more` otherwise. A value at the end of the input
+     * may be extended by the next piece, so it is only complete once a character that cannot
+     * continue it arrives, or `finish` is called.
+     */
+    constexpr scan_status feed(const char *data, size_t len) noexcept {
+      for (size_t i = 0; i < len && status_ != scan_status::failed; ++i) {
+        process_(data[i]);
+      }
+      return status_;
+    }
+
+    /**
+     * Overload for the case where the size can be obtained automatically.
+     */
+    constexpr scan_status feed(::etl::string_view data) noexcept {
+      return feed(data.data(), data.size());
+    }
+
+    /**
+     * Marks the end of the input, completing the last value.
+     *
+     * Returns `matched` if the whole input matches the format string, and `failed` otherwise.
+     */
+    constexpr scan_status finish() noexcept {
+      while (status_ != scan_status::failed && token_len_) {
+        resolve_(true);
+      }
+      if (status_ != scan_status::matched) {
+        status_ = scan_status::failed;
+      }
+      return status_;
+    }
+
+    // The result of the last call.
+    constexpr scan_status status() const noexcept {
+      return status_;
+    }
+
+  private:
+    using segment_type = typename sscan_pattern<N, Sets>::segment_type;
+
+    constexpr void process_(char c) noexcept {
+      if (status_ == scan_status::failed) {
+        return;
+      }
+      if (token_len_) {
+        append_token_(c);
+        return;
+      }
+      bool ws = sscan_eats_white_space && is_white_space(c);
+      for (; seg_ < pattern_.num_segments_; ++seg_) {
+        auto &sg = pattern_.segments_[seg_];
+        if (sg.type == segment_type::white_space) {
+          if (ws) {
+            return;
+          }
+          continue;
+        }
+        if (ws) {
+          // white space in the input is skipped outside of values
+          return;
+        }
+        if (sg.type == segment_type::placeholder && arg_ < sizeof...(Args)) {
+          append_token_(c);
+          return;
+        }
+        // literal, or a placeholder without a variable, which is compared as is
+        if (c != pattern_.format_[sg.begin + lit_pos_]) {
+          status_ = scan_status::failed;
+          return;
+        }
+        if (++lit_pos_ == sg.len) {
+          lit_pos_ = 0;
+          ++seg_;
+          update_status_();
+        }
+        return;
+      }
+      // the format is complete, so only white space may follow
+      if (!ws) {
+        status_ = scan_status::failed;
+      }
+    }
+
+    constexpr void append_token_(char c) noexcept {
+      append_arg_(std::make_index_sequence<sizeof...(Args)>{}, c);
+    }
+
+    template<size_t ...I>
+    constexpr void append_arg_(std::index_sequence<I...>, char c) noexcept {
+      ((arg_ == I && (append_value_(std::get<I>(args_), c), true)) || ...);
+    }
+
+    template<class Arg>
+    constexpr void append_value_(Arg &arg, char c) noexcept {
+      using T = std::decay_t<Arg>;
+      auto &sg = pattern_.segments_[seg_];
+      if (!token_len_ && sg.set > Sets) {
+        // parsed once for the whole token
+        set_.parse(pattern_.format_ + sg.begin + 1);
+      }
+      if constexpr (is_scan_string<T>::value) {
+        if (sg.set ? current_set_()(c) : is_non_white_space(c)) {
+          append_string_(arg, c);
+          ++token_len_;
+          return;
+        }
+        // the string ends before c, which goes on to the rest of the format
+        if (!token_len_) {
+          status_ = scan_status::failed;
+          return;
+        }
+        complete_value_(nullptr, 0);
+        process_(c);
+      } else {
+        if (token_len_ == TokenLen) {
+          status_ = scan_status::failed;
+          return;
+        }
+        token_[token_len_++] = c;
+        if (!extends_value_<T>(c)) {
+          resolve_value_(arg, false);
+        }
+      }
+    }
+
+    // writes the next character of a string variable.
+    template<class Arg>
+    constexpr void append_string_(Arg &arg, char c) noexcept {
+      using T = std::decay_t<Arg>;
+      if constexpr (std::is_pointer_v<T>) {
+        using NoRef = std::remove_reference_t<Arg>;
+        if constexpr (std::is_array_v<NoRef>) {
+          if (token_len_ < std::extent_v<NoRef> - 1) {
+            arg[token_len_] = c;
+            arg[token_len_ + 1] = '\0';
+          }
+        } else {
+          arg[token_len_] = c;
+        }
+      } else {
+        if (!token_len_) {
+          arg.clear();
+        }
+        if (arg.size() < arg.max_size()) {
+          arg.push_back(c);
+        }
+      }
+    }
+
+    // whether the character certainly continues the value being buffered, so that it does not
+    // need to be parsed yet.
+    template<class T>
+    constexpr bool extends_value_(char c) const noexcept {
+      auto &sg = pattern_.segments_[seg_];
+      if (sg.set) {
+        return current_set_()(c);
+      }
+      if constexpr (is_scan_integer<T>::value) {
+        // a digit of the base; base 0 takes hex digits, which the prefix may allow
+        unsigned digit = is_digit(c) ? unsigned(c - '0') : unsigned(c | 0x20) - 'a' + 10;
+        return digit < (sg.base ? sg.base : 16u);
+      } else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double> || is_fixed<T>::value) {
+        return is_digit(c);
+      } else {
+        return false;
+      }
+    }
+
+    // the scanset of the current placeholder.
+    constexpr const scan_set &current_set_() const noexcept {
+      if constexpr (Sets > 0) {
+        auto &sg = pattern_.segments_[seg_];
+        if (sg.set <= Sets) {
+          return pattern_.sets_.sets[sg.set - 1];
+        }
+      }
+      return set_;
+    }
+
+    constexpr void resolve_(bool end) noexcept {
+      resolve_arg_(std::make_index_sequence<sizeof...(Args)>{}, end);
+    }
+
+    template<size_t ...I>
+    constexpr void resolve_arg_(std::index_sequence<I...>, bool end) noexcept {
+      ((arg_ == I && (resolve_value_(std::get<I>(args_), end), true)) || ...);
+    }
+
+    template<class Arg>
+    constexpr void resolve_value_(Arg &arg, bool end) noexcept {
+      if constexpr (is_scan_string<std::decay_t<Arg>>::value) {
+        // only the end of the input completes a string here
+        complete_value_(nullptr, 0);
+        return;
+      }
+      size_t n = 0;
+      if (pattern_.segments_[seg_].set) {
+        // the token went on as long as the characters were in the set
+        n = sscan_token(token_, token_len_, current_set_(), arg);
+      } else {
+        unsigned base = pattern_.segments_[seg_].base;
+        n = sscan_value(token_, token_len_, arg, base);
+        if (!end && may_continue_<std::decay_t<Arg>>(n, base)) {
+          return;
+        }
+      }
+      if (!n) {
+        status_ = scan_status::failed;
+        return;
+      }
+      // the value is complete; whatever follows it goes on to the rest of the format
+      char rest[TokenLen] {};
+      size_t rest_len = token_len_ - n;
+      for (size_t i = 0; i < rest_len; ++i) {
+        rest[i] = token_[n + i];
+      }
+      complete_value_(rest, rest_len);
+    }
+
+    // moves on to the next segment and processes the characters that followed the value.
+    constexpr void complete_value_(const char *rest, size_t rest_len) noexcept {
+      token_len_ = 0;
+      ++seg_;
+      ++arg_;
+      update_status_();
+      for (size_t i = 0; i < rest_len; ++i) {
+        process_(rest[i]);
+      }
+    }
+
+    // whether more input could still change the value parsed from the buffered characters, of
+    // which the first n were consumed
+    template<class T>
+    constexpr bool may_continue_(size_t n, unsigned base) const noexcept {
+      auto rest_is = [this, n](const char *str) {
+        size_t i = n;
+        for (; i < token_len_ && *str; ++i, ++str) {
+          if (token_[i] != *str) {
+            return false;
+          }
+        }
+        return i == token_len_ && !*str;
+      };
+      if constexpr (std::is_same_v<T, char> || std::is_same_v<T, unsigned char>) {
+        return false;
+      } else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+        if (!n) {
+          return rest_is("+") || rest_is("-") || rest_is(".") || rest_is("+.") || rest_is("-.");
+        }
+        return rest_is("") || rest_is("e") || rest_is("E") || rest_is("e+") || rest_is("e-") || rest_is("E+") || rest_is("E-");
+      } else if constexpr (is_scan_integer<T>::value) {
+        if (!n) {
+          return std::is_signed_v<T> && rest_is("-");
+        }
+        // the digits of 0x or 0b may still follow
+        bool x = base == 16 || base == 0, b = base == 2 || base == 0;
+        return rest_is("") || (x && (rest_is("x") || rest_is("X"))) || (b && (rest_is("b") || rest_is("B")));
+      } else if constexpr (is_fixed<T>::value) {
+        if (!n) {
+          return rest_is("+") || rest_is("-") || rest_is(".") || rest_is("+.") || rest_is("-.");
+        }
+        return rest_is("");
+      } else if constexpr (!std::is_same_v<decltype(from_stringer<T>{}(std::declval<::etl::string_view>(), std::declval<T &>())), unsupported_from_string_type>) {
+        // a custom parser may only match once more characters arrive
+        return !n || rest_is("");
+      } else {
+        return n && rest_is("");
+      }
+    }
+
+    constexpr void update_status_() noexcept {
+      if (status_ == scan_status::failed) {
+        return;
+      }
+      status_ = scan_status::needs_more;
+      if (token_len_ || lit_pos_) {
+        return;
+      }
+      for (size_t seg = seg_; seg < pattern_.num_segments_; ++seg) {
+        auto type = pattern_.segments_[seg].type;
+        if (type != segment_type::white_space) {
+          return;
+        }
+      }
+      status_ = scan_status::matched;
+    }
+
+    const sscan_pattern<N, Sets> &pattern_;
+    std::tuple<Args &...> args_;
+    size_t seg_ = 0, lit_pos_ = 0, arg_ = 0;
+    char token_[TokenLen] {};
+    // the number of characters of the current value, buffered or written to a string
+    size_t token_len_ = 0;
+    // the scanset of the current placeholder if it is not compiled in the pattern
+    scan_set set_ {};
+    scan_status status_ = scan_status::needs_more;
+  };
+
+  template<size_t N, size_t Sets, class ...Args>
+  sscan_stream(const sscan_pattern<N, Sets> &, Args &...) -> sscan_stream<N, Sets, sscan_stream_token_len, Args...>;
+
+  /**
+   * Makes a `sscan_stream` that buffers values of up to TokenLen characters.
+   */
+  template<size_t TokenLen, size_t N, size_t Sets, class ...Args>
+  constexpr inline sscan_stream<N, Sets, TokenLen, Args...> make_sscan_stream(const sscan_pattern<N, Sets> &pattern, Args &...args) noexcept {
+    return {pattern, args...};
+  }
+
+  /**
+   * A lazy range of the values captured by repeatedly matching the start of a buffer against
+   * a format string, as if `sscan_prefix` was called in a loop. Use `scan_iter` to make one.
+   */
+  template<class Format, class ...Args>
+  class scan_iter_range {
+  public:
+    // Constructor.
+    constexpr scan_iter_range(::etl::string_view buffer, Format format, const char *separator) noexcept
+      : buffer_{buffer}, format_{format}, separator_{separator} {}
+
+    /**
+     * A [`forward iterator`](https://en.cppreference.com/w/cpp/named_req/ForwardIterator) over
+     * `std::tuple<Args...>`. Every increment scans the next match, and iteration stops at the
+     * first place that does not match.
+     */
+    class iterator {
+    public:
+      using difference_type = ptrdiff_t;
+      using value_type = std::tuple<Args...>;
+      using pointer = const value_type *;
+      using reference = const value_type &;
+      using iterator_category = std::forward_iterator_tag;
+
+      // The end iterator.
+      constexpr iterator() noexcept = default;
+
+      constexpr bool operator==(const iterator &other) const noexcept {
+        return next_ == other.next_;
+      }
+
+      constexpr bool operator!=(const iterator &other) const noexcept {
+        return !(*this == other);
+      }
+
+      constexpr iterator &operator++() noexcept {
+        advance_();
+        return *this;
+      }
+
+      constexpr iterator operator++(int) noexcept {
+        auto old = *this;
+        advance_();
+        return old;
+      }
+
+      constexpr reference operator*() const noexcept {
+        return value_;
+      }
+
+      constexpr pointer operator->() const noexcept {
+        return &value_;
+      }
+
+    private:
+      constexpr iterator(const scan_iter_range *that) noexcept
+        : that_{that}, next_{that->buffer_.data()}, len_{that->buffer_.size()} {
+        advance_();
+      }
+
+      constexpr void advance_() noexcept {
+        if (!next_) {
+          return;
+        }
+        if (next_ != that_->buffer_.data() && *that_->separator_) {
+          size_t i = sscan_prefix(next_, len_, that_->separator_);
+          next_ += i;
+          len_ -= i;
+        }
+        size_t i = len_ ? std::apply([this](auto &...args) {
+          return sscan_prefix(next_, len_, that_->format(), args...);
+        }, value_) : 0;
+        if (!i) {
+          // end
+          next_ = nullptr;
+          len_ = 0;
+          return;
+        }
+        next_ += i;
+        len_ -= i;
+      }
+
+      friend class scan_iter_range;
+      const scan_iter_range *that_ = nullptr;
+      // where the next match starts, or null at the end
+      const char *next_ = nullptr;
+      size_t len_ = 0;
+      value_type value_ {};
+    };
+
+    constexpr iterator begin() const noexcept {
+      return iterator{this};
+    }
+
+    constexpr iterator end() const noexcept {
+      return iterator{};
+    }
+
+  private:
+    constexpr decltype(auto) format() const noexcept {
+      if constexpr (std::is_pointer_v<Format> && !std::is_same_v<Format, const char *>) {
+        return *format_;
+      } else {
+        return format_;
+      }
+    }
+
+    ::etl::string_view buffer_;
+    Format format_;
+    const char *separator_;
+  };
+
+  /**
+   * Returns a lazy range of `std::tuple<Args...>` with the values of each match of the format
+   * string, which is matched over and over against the start of the rest of the buffer. The
+   * separator (if not empty) is skipped between two matches when it is there. Nothing is copied
+   * or allocated; string views point into the buffer, which must outlive the range.
+   */
+  template<class ...Args>
+  constexpr inline scan_iter_range<const char *, Args...> scan_iter(::etl::string_view buffer, const char *format, const char *separator = "") noexcept {
+    return {buffer, format, separator};
+  }
+
+  /**
+   * Same as above, but takes a precompiled format string, which must outlive the range.
+   */
+  template<class ...Args, size_t N, size_t S>
+  constexpr inline scan_iter_range<const sscan_pattern<N, S> *, Args...> scan_iter(::etl::string_view buffer, const sscan_pattern<N, S> &pattern, const char *separator = "") noexcept {
+    return {buffer, &pattern, separator};
+  }
+
 }  // namespace troll
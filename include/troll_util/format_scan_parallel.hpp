@@ -0,0 +1,177 @@
+/**
+ * -- troll --
+ *
+ * Copyright (c) 2023 dearoneesama
+ *
+ * This software is licensed under MIT License.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <functional>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "format_scan.hpp"
+
+// utilities in this header require a hosted POSIX environment (threads, mmap).
+
+namespace troll {
+
+  // below this many bytes per thread, the input is scanned on the calling thread only
+  static constexpr size_t scan_records_min_chunk = 1 << 16;
+
+  struct scan_records_result {
+    // false if the file could not be read
+    bool ok;
+    size_t matched, failed;
+  };
+
+  /**
+   * Calls on_record(tuple) for every line of [begin, end) that matches the pattern, and
+   * on_failed(index) with the index of the line otherwise. Returns the number of lines.
+   */
+  template<class ...Args, size_t N, size_t S, class OnRecord, class OnFailed>
+  inline size_t scan_lines_(const char *begin, const char *end, const sscan_pattern<N, S> &pattern, OnRecord &&on_record, OnFailed &&on_failed) {
+    size_t lines = 0;
+    while (begin != end) {
+      auto newline = static_cast<const char *>(__builtin_memchr(begin, '\n', size_t(end - begin)));
+      const char *line_end = newline ? newline : end;
+      std::tuple<Args...> record {};
+      bool matched = std::apply([&](auto &...args) {
+        return sscan(begin, size_t(line_end - begin), pattern, args...);
+      }, record);
+      if (matched) {
+        on_record(std::move(record));
+      } else {
+        on_failed(lines);
+      }
+      ++lines;
+      begin = newline ? newline + 1 : end;
+    }
+    return lines;
+  }
+
+  /**
+   * Scans every line of the buffer with the pattern, the same as calling `sscan` on each line
+   * with variables of types Args. The matched values are written to out as `std::tuple<Args...>`
+   * and the (1-based) numbers of the lines that did not match are written to failed, both in
+   * the order of the lines. A newline at the very end does not start another line.
+   *
+   * The buffer is split at line boundaries into one chunk per thread, and the records of every
+   * chunk are collected on its own thread before they are written out in order. String views
+   * point into the buffer.
+   */
+  template<class ...Args, size_t N, size_t S, class OutIt, class FailedIt>
+  inline scan_records_result scan_records(
+    std::string_view buffer, const sscan_pattern<N, S> &pattern, OutIt out, FailedIt failed,
+    size_t num_threads = std::thread::hardware_concurrency()
+  ) {
+    using record_type = std::tuple<Args...>;
+    const char *data = buffer.data();
+    size_t len = buffer.size();
+    scan_records_result result {true, 0, 0};
+
+    if (num_threads > len / scan_records_min_chunk) {
+      num_threads = len / scan_records_min_chunk;
+    }
+    if (num_threads < 2) {
+      scan_lines_<Args...>(data, data + len, pattern,
+        [&](record_type &&record) { *out++ = std::move(record); ++result.matched; },
+        [&](size_t line) { *failed++ = line + 1; ++result.failed; });
+      return result;
+    }
+
+    struct chunk {
+      const char *begin, *end;
+      std::vector<record_type> records;
+      std::vector<size_t> failed;
+      size_t lines;
+    };
+    std::vector<chunk> chunks(num_threads);
+    const char *begin = data;
+    for (size_t t = 0; t < num_threads; ++t) {
+      const char *end = data + len;
+      if (t + 1 < num_threads) {
+        const char *cut = data + (t + 1) * (len / num_threads);
+        cut = cut < begin ? begin : cut;
+        auto newline = static_cast<const char *>(__builtin_memchr(cut, '\n', size_t(end - cut)));
+        end = newline ? newline + 1 : end;
+      }
+      chunks[t].begin = begin;
+      chunks[t].end = end;
+      begin = end;
+    }
+
+    auto work = [&pattern](chunk &c) {
+      c.lines = scan_lines_<Args...>(c.begin, c.end, pattern,
+        [&c](record_type &&record) { c.records.push_back(std::move(record)); },
+        [&c](size_t line) { c.failed.push_back(line); });
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads - 1);
+    // the calling thread takes the first chunk
+    for (size_t t = 1; t < num_threads; ++t) {
+      workers.emplace_back(work, std::ref(chunks[t]));
+    }
+    work(chunks[0]);
+    for (auto &w : workers) {
+      w.join();
+    }
+
+    size_t first_line = 0;
+    for (auto &c : chunks) {
+      for (auto &record : c.records) {
+        *out++ = std::move(record);
+      }
+      for (size_t line : c.failed) {
+        *failed++ = first_line + line + 1;
+      }
+      result.matched += c.records.size();
+      result.failed += c.failed.size();
+      first_line += c.lines;
+    }
+    return result;
+  }
+
+  /**
+   * Same as `scan_records` on the contents of the file at the path, which is memory-mapped
+   * instead of read. Returns a result that is not `ok` if the file cannot be opened or mapped.
+   */
+  template<class ...Args, size_t N, size_t S, class OutIt, class FailedIt>
+  inline scan_records_result scan_records_file(
+    const char *path, const sscan_pattern<N, S> &pattern, OutIt out, FailedIt failed,
+    size_t num_threads = std::thread::hardware_concurrency()
+  ) {
+    static_assert(!(is_scan_string_view<Args>::value || ...), "string views cannot outlive the mapping");
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+      return {false, 0, 0};
+    }
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+      ::close(fd);
+      return {false, 0, 0};
+    }
+    size_t len = size_t(st.st_size);
+    if (!len) {
+      ::close(fd);
+      return {true, 0, 0};
+    }
+    void *map = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+      return {false, 0, 0};
+    }
+    ::madvise(map, len, MADV_SEQUENTIAL);
+    auto result = scan_records<Args...>(std::string_view(static_cast<const char *>(map), len), pattern, out, failed, num_threads);
+    ::munmap(map, len);
+    return result;
+  }
+
+}  // namespace troll
@@ -0,0 +1,150 @@
+/**
+ * -- troll --
+ *
+ * Copyright (c) 2023 dearoneesama
+ *
+ * This software is licensed under MIT License.
+ */
+
+#pragma once
+
+#include "format.hpp"
+
+#if __STDC_HOSTED__
+#include <chrono>
+#endif
+
+namespace troll {
+
+  /**
+   * A tick count that is formatted as `hh:mm:ss.fff` by a `{}` placeholder, with FracDigits
+   * digits after the dot (none if zero). The hours have two digits or more, so it also suits
+   * uptimes that are longer than a day.
+   */
+  template<uint64_t TicksPerSecond, unsigned FracDigits = 3>
+  struct clock_time {
+    static_assert(TicksPerSecond > 0, "a second must have ticks");
+    static_assert(FracDigits <= 9, "at most nanoseconds are supported");
+    static_assert(TicksPerSecond <= UINT64_MAX / pow10_(FracDigits), "the fraction would overflow");
+
+    uint64_t ticks;
+
+    // the longest text, excluding the nul.
+    static constexpr size_t max_size = 20 + 6 + (FracDigits ? FracDigits + 1 : 0);
+  };
+
+  using clock_time_ms = clock_time<1000, 3>;
+
+  // writes "hh:mm:ss" of the seconds, and the dot if there are fractional digits.
+  template<unsigned FracDigits>
+  constexpr inline char *write_clock_seconds_(char *dest, uint64_t secs) noexcept {
+    uint64_t hours = secs / 3600;
+    dest = hours < 100 ? write_fixed_digits_(dest, hours, 2) : write_digits_(dest, hours);
+    *dest++ = ':';
+    dest = write_fixed_digits_(dest, secs / 60 % 60, 2);
+    *dest++ = ':';
+    dest = write_fixed_digits_(dest, secs % 60, 2);
+    if constexpr (FracDigits > 0) {
+      *dest++ = '.';
+    }
+    return dest;
+  }
+
+  // the fractional digits of the ticks within a second.
+  template<uint64_t TicksPerSecond, unsigned FracDigits>
+  constexpr inline uint64_t clock_fraction_(uint64_t ticks) noexcept {
+    return ticks % TicksPerSecond * pow10_(FracDigits) / TicksPerSecond;
+  }
+
+  /**
+   * Writes the tick count as `hh:mm:ss.fff` and returns the end. The destination needs
+   * `clock_time::max_size` characters at most; the nul is not written.
+   */
+  template<uint64_t TicksPerSecond, unsigned FracDigits>
+  constexpr inline char *write_clock_time(char *dest, clock_time<TicksPerSecond, FracDigits> t) noexcept {
+    dest = write_clock_seconds_<FracDigits>(dest, t.ticks / TicksPerSecond);
+    return write_fixed_digits_(dest, clock_fraction_<TicksPerSecond, FracDigits>(t.ticks), FracDigits);
+  }
+
+  template<uint64_t TicksPerSecond, unsigned FracDigits>
+  struct to_stringer<clock_time<TicksPerSecond, FracDigits>> {
+    void operator()(const clock_time<TicksPerSecond, FracDigits> &t, ::etl::istring &s) const {
+      char buf[clock_time<TicksPerSecond, FracDigits>::max_size];
+      s.append(buf, size_t(write_clock_time(buf, t) - buf));
+    }
+  };
+
+  /**
+   * Renders timestamps of increasing tick counts, such as the one at the start of every log
+   * line. The `hh:mm:ss.` prefix is kept from the previous call within the same second, so only
+   * the fractional digits are written again.
+   *
+   * The instance is not thread-safe; use one per thread or per output.
+   */
+  template<uint64_t TicksPerSecond, unsigned FracDigits = 3>
+  class timestamp_cache {
+  public:
+    using time_type = clock_time<TicksPerSecond, FracDigits>;
+
+    /**
+     * Renders the tick count and returns the nul-terminated text, which stays valid until the
+     * next call.
+     */
+    const char *render(uint64_t ticks) noexcept {
+      uint64_t secs = ticks / TicksPerSecond;
+      if (secs != secs_ || !prefix_len_) {
+        secs_ = secs;
+        prefix_len_ = size_t(write_clock_seconds_<FracDigits>(buf_, secs) - buf_);
+      }
+      char *end = write_fixed_digits_(buf_ + prefix_len_, clock_fraction_<TicksPerSecond, FracDigits>(ticks), FracDigits);
+      *end = '\0';
+      size_ = size_t(end - buf_);
+      return buf_;
+    }
+
+    // The length of the last rendered text.
+    size_t size() const noexcept {
+      return size_;
+    }
+
+    ::etl::string_view view() const noexcept {
+      return {buf_, size_};
+    }
+
+  private:
+    char buf_[time_type::max_size + 1] {};
+    uint64_t secs_ = 0;
+    size_t prefix_len_ = 0, size_ = 0;
+  };
+
+#if __STDC_HOSTED__
+
+  /**
+   * Formats the duration as `hh:mm:ss.fff`, with the precision of milliseconds and a minus sign
+   * if it is negative.
+   */
+  template<class Rep, class Period>
+  struct to_stringer<std::chrono::duration<Rep, Period>> {
+    void operator()(const std::chrono::duration<Rep, Period> &d, ::etl::istring &s) const {
+      auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+      char buf[1 + clock_time_ms::max_size], *p = buf;
+      if (ms < 0) {
+        *p++ = '-';
+      }
+      s.append(buf, size_t(write_clock_time(p, clock_time_ms{ms < 0 ? 0 - uint64_t(ms) : uint64_t(ms)}) - buf));
+    }
+  };
+
+  /**
+   * The UTC time of the day of the time point, to be formatted as `hh:mm:ss.fff`.
+   */
+  template<class Duration>
+  inline clock_time_ms utc_time_of_day(std::chrono::time_point<std::chrono::system_clock, Duration> tp) noexcept {
+    constexpr int64_t day = 24 * 60 * 60 * 1000;
+    int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count() % day;
+    return {uint64_t(ms < 0 ? ms + day : ms)};
+  }
+
+#endif  // __STDC_HOSTED__
+
+}  // namespace troll
@@ -0,0 +1,202 @@
+/**
+ * -- troll --
+ *
+ * Copyright (c) 2023 dearoneesama
+ *
+ * This software is licensed under MIT License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+// counters for formatting, scanning and output_control, which are compiled out unless
+// TROLL_INSTRUMENT is defined. it must be defined the same way in every translation unit.
+#if !defined(TROLL_INSTRUMENT_MAX_SITES)
+#define TROLL_INSTRUMENT_MAX_SITES 64
+#endif
+
+namespace troll {
+
+#if defined(TROLL_INSTRUMENT)
+  static constexpr bool instrument_enabled = true;
+#else
+  static constexpr bool instrument_enabled = false;
+#endif
+
+  // the number of distinct format strings that are counted, for formatting and scanning each.
+  static constexpr size_t instrument_max_sites = TROLL_INSTRUMENT_MAX_SITES;
+
+  // latency bucket i counts calls that took [2^i, 2^(i+1)) ticks of the clock; the last one
+  // also takes everything longer.
+  static constexpr size_t instrument_latency_buckets = 24;
+
+  // The type of the counters: 64 bits where atomics of that width are lock-free, otherwise the
+  // width of a pointer, so that 32-bit targets need no libatomic.
+  using instrument_counter = std::conditional_t<__atomic_always_lock_free(sizeof(uint64_t), 0), uint64_t, uintptr_t>;
+
+  // Counters of `snformat` (and everything built on it) for one format string.
+  struct instrument_format_site {
+    // The format string, or nullptr if the site is not used.
+    const char *format;
+    instrument_counter calls;
+    // Characters written, excluding the nul.
+    instrument_counter bytes;
+    // Calls whose result filled the whole buffer, which includes exact fits.
+    instrument_counter truncations;
+    instrument_counter latency[instrument_latency_buckets];
+  };
+
+  // Counters of `sscan` and `sscan_prefix` for one format string or pattern.
+  struct instrument_scan_site {
+    // The format string, or nullptr if the site is not used.
+    const char *format;
+    instrument_counter matches, fails;
+    instrument_counter latency[instrument_latency_buckets];
+  };
+
+  // Counters of one `output_control`.
+  struct output_control_stats {
+    // The most requests that were queued at once.
+    size_t max_queue_depth;
+    // Requests that were not queued since the queue was full.
+    size_t drops;
+    size_t dequeues;
+    // Characters returned by `dequeue` in total, and at most by one call.
+    size_t dequeued_bytes, max_dequeue_bytes;
+  };
+
+  // A function that returns a timestamp in any unit, such as a cycle counter.
+  using instrument_clock = uint64_t (*)();
+
+#if defined(TROLL_INSTRUMENT)
+
+  // A fixed table of sites, keyed by the address of the format string.
+  template<class Site>
+  struct instrument_table {
+    Site sites[instrument_max_sites];
+    // calls that were not counted since every site was taken
+    instrument_counter lost;
+
+    // finds or claims the site of the format string.
+    Site *find(const char *format) noexcept {
+      size_t h = size_t((uintptr_t(format) >> 2) * uintptr_t(0x9e3779b97f4a7c15ull));
+      for (size_t i = 0; i < instrument_max_sites; ++i) {
+        Site &site = sites[(h + i) % instrument_max_sites];
+        const char *key = __atomic_load_n(&site.format, __ATOMIC_ACQUIRE);
+        if (!key) {
+          const char *expected = nullptr;
+          if (__atomic_compare_exchange_n(&site.format, &expected, format, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return &site;
+          }
+          key = expected;
+        }
+        if (key == format) {
+          return &site;
+        }
+      }
+      __atomic_fetch_add(&lost, 1, __ATOMIC_RELAXED);
+      return nullptr;
+    }
+  };
+
+  inline instrument_table<instrument_format_site> instrument_format_sites_ {};
+  inline instrument_table<instrument_scan_site> instrument_scan_sites_ {};
+  inline instrument_clock instrument_clock_ = nullptr;
+
+  inline uint64_t instrument_now_() noexcept {
+    auto clock = __atomic_load_n(&instrument_clock_, __ATOMIC_RELAXED);
+    return clock ? clock() : 0;
+  }
+
+  inline void instrument_latency_(instrument_counter *latency, uint64_t ticks) noexcept {
+    size_t bucket = ticks ? size_t(63 - __builtin_clzll(ticks)) : 0;
+    bucket = bucket < instrument_latency_buckets ? bucket : instrument_latency_buckets - 1;
+    __atomic_fetch_add(&latency[bucket], 1, __ATOMIC_RELAXED);
+  }
+
+  inline void instrument_format_(const char *format, size_t bytes, bool filled, uint64_t ticks) noexcept {
+    if (auto site = instrument_format_sites_.find(format)) {
+      __atomic_fetch_add(&site->calls, 1, __ATOMIC_RELAXED);
+      __atomic_fetch_add(&site->bytes, bytes, __ATOMIC_RELAXED);
+      if (filled) {
+        __atomic_fetch_add(&site->truncations, 1, __ATOMIC_RELAXED);
+      }
+      instrument_latency_(site->latency, ticks);
+    }
+  }
+
+  inline void instrument_scan_(const char *format, bool matched, uint64_t ticks) noexcept {
+    if (auto site = instrument_scan_sites_.find(format)) {
+      __atomic_fetch_add(matched ? &site->matches : &site->fails, 1, __ATOMIC_RELAXED);
+      instrument_latency_(site->latency, ticks);
+    }
+  }
+
+  /**
+   * Sets the clock used to measure the latency of every call, or nullptr to stop measuring.
+   * Without a clock, every call falls in the first latency bucket.
+   */
+  inline void instrument_set_clock(instrument_clock clock) noexcept {
+    __atomic_store_n(&instrument_clock_, clock, __ATOMIC_RELAXED);
+  }
+
+  inline void instrument_clear_(instrument_counter *latency) noexcept {
+    for (size_t i = 0; i < instrument_latency_buckets; ++i) {
+      __atomic_store_n(&latency[i], 0, __ATOMIC_RELAXED);
+    }
+  }
+
+  inline void instrument_clear_(instrument_format_site &site) noexcept {
+    __atomic_store_n(&site.calls, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&site.bytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&site.truncations, 0, __ATOMIC_RELAXED);
+    instrument_clear_(site.latency);
+  }
+
+  inline void instrument_clear_(instrument_scan_site &site) noexcept {
+    __atomic_store_n(&site.matches, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&site.fails, 0, __ATOMIC_RELAXED);
+    instrument_clear_(site.latency);
+  }
+
+  // clears the counters of every site, and then gives the site up to be claimed again.
+  template<class Site>
+  inline void instrument_clear_(instrument_table<Site> &table) noexcept {
+    for (auto &site : table.sites) {
+      instrument_clear_(site);
+      __atomic_store_n(&site.format, nullptr, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&table.lost, 0, __ATOMIC_RELAXED);
+  }
+
+  /**
+   * Clears every counter. Every field is cleared atomically, but calls that are counted at the
+   * same time may be lost, or counted to the site that claims theirs next.
+   */
+  inline void instrument_reset() noexcept {
+    instrument_clear_(instrument_format_sites_);
+    instrument_clear_(instrument_scan_sites_);
+  }
+
+  // The counters of every format string that has been formatted.
+  inline const instrument_table<instrument_format_site> &instrument_format_sites() noexcept {
+    return instrument_format_sites_;
+  }
+
+  // The counters of every format string or pattern that has been scanned.
+  inline const instrument_table<instrument_scan_site> &instrument_scan_sites() noexcept {
+    return instrument_scan_sites_;
+  }
+
+#else
+
+  inline void instrument_set_clock(instrument_clock) noexcept {}
+
+  inline void instrument_reset() noexcept {}
+
+#endif  // TROLL_INSTRUMENT
+
+}  // namespace troll
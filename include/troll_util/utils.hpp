@@ -10,8 +10,27 @@
 
 #include <utility>
 #include <iterator>
+#include <tuple>
+#include <type_traits>
 
 namespace troll {
+  // the traversal an iterator supports: `iterator_concept` if it has one, which iterators that
+  // return by value use to keep their operators, otherwise `iterator_category`.
+  template<class It, class = void>
+  struct iterator_traversal_ {
+    using type = typename std::iterator_traits<It>::iterator_category;
+  };
+
+  template<class It>
+  struct iterator_traversal_<It, std::void_t<typename It::iterator_concept>> {
+    using type = typename It::iterator_concept;
+  };
+
+  template<class It>
+  static constexpr bool is_random_access_iterator_v = std::is_base_of_v<
+    std::random_access_iterator_tag, typename iterator_traversal_<It>::type
+  >;
+
   /**
    * Iterator to transform a range.
    */
@@ -24,15 +43,22 @@ namespace troll {
 
     /**
      * In general, an
-     * [`input iterator`](https://en.cppreference.com/w/cpp/named_req/InputIterator).
+     * [`input iterator`](https://en.cppreference.com/w/cpp/named_req/InputIterator), since the
+     * function returns by value. It keeps the operators of the source iterator though, and
+     * `iterator_concept` is the category of the source, so a random access source can still be
+     * jumped around (the function is called on each dereference). If the function returns an
+     * lvalue reference, `iterator_category` is the category of the source as well.
     */
     class iterator {
     public:
-      using difference_type = size_t;  // never
-      using value_type = decltype(std::declval<Fn>()(*std::declval<InputIt>()));
-      using pointer = const value_type *;
-      using reference = const value_type &;
-      using iterator_category = std::input_iterator_tag;
+      using difference_type = typename std::iterator_traits<InputIt>::difference_type;
+      using reference = decltype(std::declval<Fn &>()(*std::declval<InputIt>()));
+      using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+      using pointer = void;
+      using iterator_concept = std::conditional_t<
+        is_random_access_iterator_v<InputIt>, std::random_access_iterator_tag, typename iterator_traversal_<InputIt>::type
+      >;
+      using iterator_category = std::conditional_t<std::is_lvalue_reference_v<reference>, iterator_concept, std::input_iterator_tag>;
 
       constexpr bool operator==(const iterator &other) const noexcept {
         return curr_ == other.curr_ && that_ == other.that_;
@@ -47,10 +73,75 @@ namespace troll {
         return *this;
       }
 
+      constexpr iterator operator++(int) noexcept {
+        auto old = *this;
+        ++curr_;
+        return old;
+      }
+
       constexpr decltype(auto) operator*() const noexcept {
         return that_->fn_(*curr_);
       }
 
+      // the following are only usable if the source iterator supports them.
+
+      constexpr iterator &operator--() noexcept {
+        --curr_;
+        return *this;
+      }
+
+      constexpr iterator operator--(int) noexcept {
+        auto old = *this;
+        --curr_;
+        return old;
+      }
+
+      constexpr iterator &operator+=(difference_type n) noexcept {
+        curr_ += n;
+        return *this;
+      }
+
+      constexpr iterator &operator-=(difference_type n) noexcept {
+        curr_ -= n;
+        return *this;
+      }
+
+      constexpr iterator operator+(difference_type n) const noexcept {
+        return iterator(that_, curr_ + n);
+      }
+
+      friend constexpr iterator operator+(difference_type n, const iterator &it) noexcept {
+        return it + n;
+      }
+
+      constexpr iterator operator-(difference_type n) const noexcept {
+        return iterator(that_, curr_ - n);
+      }
+
+      constexpr difference_type operator-(const iterator &other) const noexcept {
+        return curr_ - other.curr_;
+      }
+
+      constexpr decltype(auto) operator[](difference_type n) const noexcept {
+        return that_->fn_(curr_[n]);
+      }
+
+      constexpr bool operator<(const iterator &other) const noexcept {
+        return curr_ < other.curr_;
+      }
+
+      constexpr bool operator>(const iterator &other) const noexcept {
+        return other < *this;
+      }
+
+      constexpr bool operator<=(const iterator &other) const noexcept {
+        return !(other < *this);
+      }
+
+      constexpr bool operator>=(const iterator &other) const noexcept {
+        return !(*this < other);
+      }
+
     private:
       constexpr iterator(it_transform *that, InputIt begin) noexcept : that_(that), curr_(begin) {}
       friend class it_transform;
@@ -82,4 +173,681 @@ namespace troll {
 
   template<class InputIt, class Fn>
   it_transform(InputIt, InputIt, Fn) -> it_transform<InputIt, Fn>;
+
+  // the category of the iterator, but no more than Max.
+  template<class It, class Max>
+  using it_category_at_most_ = std::conditional_t<
+    std::is_base_of_v<Max, typename std::iterator_traits<It>::iterator_category>,
+    Max, typename std::iterator_traits<It>::iterator_category
+  >;
+
+  /**
+   * Operators of a random access iterator in terms of `+=`, `-` (distance), `==` and `*` of
+   * Derived. They are only instantiated when used.
+   */
+  template<class Derived, class Diff>
+  class it_ops_ {
+  public:
+    constexpr bool operator!=(const Derived &other) const noexcept {
+      return !(self_() == other);
+    }
+
+    constexpr Derived operator++(int) noexcept {
+      auto old = self_();
+      ++self_();
+      return old;
+    }
+
+    constexpr Derived operator--(int) noexcept {
+      auto old = self_();
+      --self_();
+      return old;
+    }
+
+    constexpr Derived &operator-=(Diff n) noexcept {
+      return self_() += -n;
+    }
+
+    constexpr Derived operator+(Diff n) const noexcept {
+      auto it = self_();
+      return it += n;
+    }
+
+    friend constexpr Derived operator+(Diff n, const Derived &it) noexcept {
+      return it + n;
+    }
+
+    constexpr Derived operator-(Diff n) const noexcept {
+      auto it = self_();
+      return it += -n;
+    }
+
+    constexpr decltype(auto) operator[](Diff n) const noexcept {
+      return *(self_() + n);
+    }
+
+    constexpr bool operator<(const Derived &other) const noexcept {
+      return self_() - other < 0;
+    }
+
+    constexpr bool operator>(const Derived &other) const noexcept {
+      return other < self_();
+    }
+
+    constexpr bool operator<=(const Derived &other) const noexcept {
+      return !(other < self_());
+    }
+
+    constexpr bool operator>=(const Derived &other) const noexcept {
+      return !(self_() < other);
+    }
+
+  private:
+    constexpr Derived &self_() noexcept {
+      return static_cast<Derived &>(*this);
+    }
+    constexpr const Derived &self_() const noexcept {
+      return static_cast<const Derived &>(*this);
+    }
+  };
+
+  /**
+   * Iterator over the elements of a range for which the predicate returns true. Elements are
+   * passed through as they are.
+   */
+  template<class InputIt, class Pred>
+  class it_filter {
+  public:
+    // Constructor.
+    constexpr it_filter(InputIt begin, InputIt end, Pred pred) noexcept
+      : begin_(begin), end_(end), pred_(std::move(pred)) {}
+
+    /**
+     * Keeps the category of the source iterator, up to a
+     * [`bidirectional iterator`](https://en.cppreference.com/w/cpp/named_req/BidirectionalIterator).
+     * The predicate is called while the iterator is moved, not on dereference.
+     */
+    class iterator : public it_ops_<iterator, typename std::iterator_traits<InputIt>::difference_type> {
+    public:
+      using difference_type = typename std::iterator_traits<InputIt>::difference_type;
+      using value_type = typename std::iterator_traits<InputIt>::value_type;
+      using pointer = typename std::iterator_traits<InputIt>::pointer;
+      using reference = typename std::iterator_traits<InputIt>::reference;
+      using iterator_category = it_category_at_most_<InputIt, std::bidirectional_iterator_tag>;
+      using it_ops_<iterator, difference_type>::operator++;
+      using it_ops_<iterator, difference_type>::operator--;
+
+      constexpr bool operator==(const iterator &other) const noexcept {
+        return curr_ == other.curr_ && that_ == other.that_;
+      }
+
+      constexpr iterator &operator++() noexcept {
+        ++curr_;
+        skip_();
+        return *this;
+      }
+
+      constexpr iterator &operator--() noexcept {
+        do {
+          --curr_;
+        } while (!that_->pred_(*curr_));
+        return *this;
+      }
+
+      constexpr decltype(auto) operator*() const noexcept {
+        return *curr_;
+      }
+
+    private:
+      constexpr iterator(it_filter *that, InputIt begin) noexcept : that_(that), curr_(begin) {
+        skip_();
+      }
+
+      constexpr void skip_() noexcept {
+        while (curr_ != that_->end_ && !that_->pred_(*curr_)) {
+          ++curr_;
+        }
+      }
+
+      friend class it_filter;
+      it_filter *that_;
+      InputIt curr_;
+    };
+
+    constexpr iterator begin() noexcept {
+      return iterator(this, begin_);
+    }
+    constexpr iterator end() noexcept {
+      return iterator(this, end_);
+    }
+
+  private:
+    friend class iterator;
+    InputIt begin_, end_;
+    Pred pred_;
+  };
+
+  template<class InputIt, class Pred>
+  it_filter(InputIt, InputIt, Pred) -> it_filter<InputIt, Pred>;
+
+  /**
+   * Iterator over at most the first n elements of a range.
+   */
+  template<class InputIt>
+  class it_take {
+  public:
+    using size_type = typename std::iterator_traits<InputIt>::difference_type;
+
+    // Constructor.
+    constexpr it_take(InputIt begin, InputIt end, size_type n) noexcept
+      : begin_(begin), end_(end), n_(n) {
+      if constexpr (is_random_access_iterator_v<InputIt>) {
+        n_ = n_ < end - begin ? n_ : end - begin;
+      }
+    }
+
+    /**
+     * Keeps the category of the source iterator, but only a random access source can go
+     * backwards.
+     */
+    class iterator : public it_ops_<iterator, typename std::iterator_traits<InputIt>::difference_type> {
+    public:
+      using difference_type = typename std::iterator_traits<InputIt>::difference_type;
+      using value_type = typename std::iterator_traits<InputIt>::value_type;
+      using pointer = typename std::iterator_traits<InputIt>::pointer;
+      using reference = typename std::iterator_traits<InputIt>::reference;
+      using iterator_category = std::conditional_t<
+        is_random_access_iterator_v<InputIt>, std::random_access_iterator_tag, it_category_at_most_<InputIt, std::forward_iterator_tag>
+      >;
+      using it_ops_<iterator, difference_type>::operator++;
+      using it_ops_<iterator, difference_type>::operator--;
+
+      constexpr bool operator==(const iterator &other) const noexcept {
+        return pos_ == other.pos_;
+      }
+
+      constexpr iterator &operator++() noexcept {
+        ++curr_;
+        ++pos_;
+        if constexpr (!is_random_access_iterator_v<InputIt>) {
+          // a short source reaches its end before n
+          pos_ = curr_ == that_->end_ ? that_->n_ : pos_;
+        }
+        return *this;
+      }
+
+      constexpr decltype(auto) operator*() const noexcept {
+        return *curr_;
+      }
+
+      // the following are only usable if the source iterator is random access.
+
+      constexpr iterator &operator--() noexcept {
+        --curr_;
+        --pos_;
+        return *this;
+      }
+
+      constexpr iterator &operator+=(difference_type n) noexcept {
+        curr_ += n;
+        pos_ += n;
+        return *this;
+      }
+
+      constexpr difference_type operator-(const iterator &other) const noexcept {
+        return pos_ - other.pos_;
+      }
+
+      using it_ops_<iterator, difference_type>::operator-;
+
+    private:
+      constexpr iterator(const it_take *that, InputIt curr, difference_type pos) noexcept : that_(that), curr_(curr), pos_(pos) {}
+      friend class it_take;
+      const it_take *that_;
+      InputIt curr_;
+      // the number of elements before this one, which is n at the end
+      difference_type pos_;
+    };
+
+    constexpr iterator begin() const noexcept {
+      if constexpr (is_random_access_iterator_v<InputIt>) {
+        return iterator(this, begin_, 0);
+      } else {
+        return iterator(this, begin_, begin_ == end_ ? n_ : 0);
+      }
+    }
+    constexpr iterator end() const noexcept {
+      if constexpr (is_random_access_iterator_v<InputIt>) {
+        return iterator(this, begin_ + n_, n_);
+      } else {
+        return iterator(this, end_, n_);
+      }
+    }
+
+  private:
+    friend class iterator;
+    InputIt begin_, end_;
+    size_type n_;
+  };
+
+  template<class InputIt, class Size>
+  it_take(InputIt, InputIt, Size) -> it_take<InputIt>;
+
+  /**
+   * Iterator over every nth element of a range, starting from the first one.
+   */
+  template<class InputIt>
+  class it_stride {
+  public:
+    using size_type = typename std::iterator_traits<InputIt>::difference_type;
+
+    // Constructor. step must be positive.
+    constexpr it_stride(InputIt begin, InputIt end, size_type step) noexcept
+      : begin_(begin), end_(end), step_(step) {}
+
+    /**
+     * Keeps the category of the source iterator, but only a random access source can go
+     * backwards. A random access source is indexed directly instead of being stepped through.
+     */
+    class iterator : public it_ops_<iterator, typename std::iterator_traits<InputIt>::difference_type> {
+    public:
+      using difference_type = typename std::iterator_traits<InputIt>::difference_type;
+      using value_type = typename std::iterator_traits<InputIt>::value_type;
+      using pointer = typename std::iterator_traits<InputIt>::pointer;
+      using reference = typename std::iterator_traits<InputIt>::reference;
+      using iterator_category = std::conditional_t<
+        is_random_access_iterator_v<InputIt>, std::random_access_iterator_tag, it_category_at_most_<InputIt, std::forward_iterator_tag>
+      >;
+      using it_ops_<iterator, difference_type>::operator++;
+      using it_ops_<iterator, difference_type>::operator--;
+
+      constexpr bool operator==(const iterator &other) const noexcept {
+        return curr_ == other.curr_ && that_ == other.that_;
+      }
+
+      constexpr iterator &operator++() noexcept {
+        if constexpr (is_random_access_iterator_v<InputIt>) {
+          ++curr_;
+        } else {
+          for (size_type i = 0; i < that_->step_ && curr_ != that_->end_; ++i) {
+            ++curr_;
+          }
+        }
+        return *this;
+      }
+
+      constexpr decltype(auto) operator*() const noexcept {
+        if constexpr (is_random_access_iterator_v<InputIt>) {
+          return that_->begin_[curr_ * that_->step_];
+        } else {
+          return *curr_;
+        }
+      }
+
+      // the following are only usable if the source iterator is random access.
+
+      constexpr iterator &operator--() noexcept {
+        --curr_;
+        return *this;
+      }
+
+      constexpr iterator &operator+=(difference_type n) noexcept {
+        curr_ += n;
+        return *this;
+      }
+
+      constexpr difference_type operator-(const iterator &other) const noexcept {
+        return curr_ - other.curr_;
+      }
+
+      using it_ops_<iterator, difference_type>::operator-;
+
+    private:
+      // the index of the element for a random access source, or the source iterator otherwise
+      using position_type = std::conditional_t<is_random_access_iterator_v<InputIt>, difference_type, InputIt>;
+      constexpr iterator(const it_stride *that, position_type curr) noexcept : that_(that), curr_(curr) {}
+      friend class it_stride;
+      const it_stride *that_;
+      position_type curr_;
+    };
+
+    constexpr iterator begin() const noexcept {
+      if constexpr (is_random_access_iterator_v<InputIt>) {
+        return iterator(this, 0);
+      } else {
+        return iterator(this, begin_);
+      }
+    }
+    constexpr iterator end() const noexcept {
+      if constexpr (is_random_access_iterator_v<InputIt>) {
+        return iterator(this, (end_ - begin_ + step_ - 1) / step_);
+      } else {
+        return iterator(this, end_);
+      }
+    }
+
+  private:
+    friend class iterator;
+    InputIt begin_, end_;
+    size_type step_;
+  };
+
+  template<class InputIt, class Size>
+  it_stride(InputIt, InputIt, Size) -> it_stride<InputIt>;
+
+  /**
+   * Iterator over several ranges side by side, the same way `tabulate` takes a title row and
+   * element rows: only the first range has an end, and the others must be at least as long.
+   * Dereferencing gives a `std::tuple` of what the source iterators give.
+   */
+  template<class InputIt, class ...InputIts>
+  class it_zip {
+  public:
+    // Constructor.
+    constexpr it_zip(InputIt begin, InputIt end, InputIts ...others) noexcept
+      : begin_(begin), end_(end), others_(others...) {}
+
+    /**
+     * An [`input iterator`](https://en.cppreference.com/w/cpp/named_req/InputIterator), since
+     * the tuple is returned by value. `iterator_concept` is the weakest category of the source
+     * iterators, whose operators it keeps.
+     */
+    class iterator : public it_ops_<iterator, typename std::iterator_traits<InputIt>::difference_type> {
+    public:
+      using difference_type = typename std::iterator_traits<InputIt>::difference_type;
+      using value_type = std::tuple<decltype(*std::declval<InputIt>()), decltype(*std::declval<InputIts>())...>;
+      using pointer = void;
+      using reference = value_type;
+      using iterator_concept = std::common_type_t<
+        typename iterator_traversal_<InputIt>::type, typename iterator_traversal_<InputIts>::type...
+      >;
+      using iterator_category = std::input_iterator_tag;
+      using it_ops_<iterator, difference_type>::operator++;
+      using it_ops_<iterator, difference_type>::operator--;
+
+      constexpr bool operator==(const iterator &other) const noexcept {
+        return std::get<0>(curr_) == std::get<0>(other.curr_);
+      }
+
+      constexpr iterator &operator++() noexcept {
+        std::apply([](auto &...its) { (++its, ...); }, curr_);
+        return *this;
+      }
+
+      constexpr value_type operator*() const noexcept {
+        return std::apply([](auto &...its) { return value_type(*its...); }, curr_);
+      }
+
+      // the following are only usable if the source iterators support them.
+
+      constexpr iterator &operator--() noexcept {
+        std::apply([](auto &...its) { (--its, ...); }, curr_);
+        return *this;
+      }
+
+      constexpr iterator &operator+=(difference_type n) noexcept {
+        std::apply([n](auto &...its) { ((its += n), ...); }, curr_);
+        return *this;
+      }
+
+      constexpr difference_type operator-(const iterator &other) const noexcept {
+        return std::get<0>(curr_) - std::get<0>(other.curr_);
+      }
+
+      using it_ops_<iterator, difference_type>::operator-;
+
+    private:
+      constexpr iterator(std::tuple<InputIt, InputIts...> curr) noexcept : curr_(curr) {}
+      friend class it_zip;
+      std::tuple<InputIt, InputIts...> curr_;
+    };
+
+    constexpr iterator begin() const noexcept {
+      return iterator(std::tuple_cat(std::make_tuple(begin_), others_));
+    }
+    constexpr iterator end() const noexcept {
+      // the other iterators are not needed to compare
+      return iterator(std::tuple_cat(std::make_tuple(end_), others_));
+    }
+
+  private:
+    InputIt begin_, end_;
+    std::tuple<InputIts...> others_;
+  };
+
+  template<class InputIt, class ...InputIts>
+  it_zip(InputIt, InputIt, InputIts...) -> it_zip<InputIt, InputIts...>;
+
+  /**
+   * A pair of iterators that can be iterated with a range-based for loop.
+   */
+  template<class InputIt>
+  struct it_range {
+    InputIt first, last;
+
+    constexpr InputIt begin() const noexcept {
+      return first;
+    }
+    constexpr InputIt end() const noexcept {
+      return last;
+    }
+  };
+
+  /**
+   * Iterator over consecutive chunks of n elements of a range, each given as an `it_range` of
+   * the source iterators. The last chunk may be shorter.
+   */
+  template<class InputIt>
+  class it_chunk {
+  public:
+    using size_type = typename std::iterator_traits<InputIt>::difference_type;
+
+    // Constructor. n must be positive.
+    constexpr it_chunk(InputIt begin, InputIt end, size_type n) noexcept
+      : begin_(begin), end_(end), n_(n) {}
+
+    /**
+     * An [`input iterator`](https://en.cppreference.com/w/cpp/named_req/InputIterator), since
+     * the chunk is returned by value. `iterator_concept` keeps the category of the source
+     * iterator, but only a random access source can go backwards. The source must be a forward
+     * iterator at least, since every element is visited twice: once to find the end of the
+     * chunk and once more through the chunk.
+     */
+    class iterator : public it_ops_<iterator, typename std::iterator_traits<InputIt>::difference_type> {
+    public:
+      using difference_type = typename std::iterator_traits<InputIt>::difference_type;
+      using value_type = it_range<InputIt>;
+      using pointer = void;
+      using reference = value_type;
+      using iterator_concept = std::conditional_t<
+        is_random_access_iterator_v<InputIt>, std::random_access_iterator_tag, std::forward_iterator_tag
+      >;
+      using iterator_category = std::input_iterator_tag;
+      using it_ops_<iterator, difference_type>::operator++;
+      using it_ops_<iterator, difference_type>::operator--;
+
+      constexpr bool operator==(const iterator &other) const noexcept {
+        return curr_ == other.curr_ && that_ == other.that_;
+      }
+
+      constexpr iterator &operator++() noexcept {
+        if constexpr (is_random_access_iterator_v<InputIt>) {
+          ++curr_;
+        } else {
+          curr_ = that_->chunk_end_(curr_);
+        }
+        return *this;
+      }
+
+      constexpr value_type operator*() const noexcept {
+        if constexpr (is_random_access_iterator_v<InputIt>) {
+          auto len = that_->end_ - that_->begin_;
+          auto first = curr_ * that_->n_;
+          auto last = len - first < that_->n_ ? len : first + that_->n_;
+          return {that_->begin_ + first, that_->begin_ + last};
+        } else {
+          return {curr_, that_->chunk_end_(curr_)};
+        }
+      }
+
+      // the following are only usable if the source iterator is random access.
+
+      constexpr iterator &operator--() noexcept {
+        --curr_;
+        return *this;
+      }
+
+      constexpr iterator &operator+=(difference_type n) noexcept {
+        curr_ += n;
+        return *this;
+      }
+
+      constexpr difference_type operator-(const iterator &other) const noexcept {
+        return curr_ - other.curr_;
+      }
+
+      using it_ops_<iterator, difference_type>::operator-;
+
+    private:
+      // the index of the chunk for a random access source, or its first source iterator otherwise
+      using position_type = std::conditional_t<is_random_access_iterator_v<InputIt>, difference_type, InputIt>;
+      constexpr iterator(const it_chunk *that, position_type curr) noexcept : that_(that), curr_(curr) {}
+      friend class it_chunk;
+      const it_chunk *that_;
+      position_type curr_;
+    };
+
+    constexpr iterator begin() const noexcept {
+      if constexpr (is_random_access_iterator_v<InputIt>) {
+        return iterator(this, 0);
+      } else {
+        return iterator(this, begin_);
+      }
+    }
+    constexpr iterator end() const noexcept {
+      if constexpr (is_random_access_iterator_v<InputIt>) {
+        return iterator(this, (end_ - begin_ + n_ - 1) / n_);
+      } else {
+        return iterator(this, end_);
+      }
+    }
+
+  private:
+    friend class iterator;
+
+    constexpr InputIt chunk_end_(InputIt it) const noexcept {
+      for (size_type i = 0; i < n_ && it != end_; ++i) {
+        ++it;
+      }
+      return it;
+    }
+
+    InputIt begin_, end_;
+    size_type n_;
+  };
+
+  template<class InputIt, class Size>
+  it_chunk(InputIt, InputIt, Size) -> it_chunk<InputIt>;
+
+  /**
+   * Iterator to transform a range like `it_transform`, but the function is called at most once
+   * per element visited: the result is kept in the iterator until it is moved. This is for
+   * functions that are too expensive to call on every dereference. The result type must be
+   * default constructible.
+   */
+  template<class InputIt, class Fn>
+  class it_transform_cached {
+  public:
+    // Constructor.
+    constexpr it_transform_cached(InputIt begin, InputIt end, Fn fn) noexcept
+      : begin_(begin), end_(end), fn_(std::move(fn)) {}
+
+    /**
+     * An [`input iterator`](https://en.cppreference.com/w/cpp/named_req/InputIterator), since
+     * the reference is to the result kept in the iterator itself. `iterator_concept` is the
+     * category of the source, whose operators it keeps. `operator[]` is not cached.
+     */
+    class iterator : public it_ops_<iterator, typename std::iterator_traits<InputIt>::difference_type> {
+    public:
+      using difference_type = typename std::iterator_traits<InputIt>::difference_type;
+      using value_type = std::decay_t<decltype(std::declval<Fn>()(*std::declval<InputIt>()))>;
+      using pointer = const value_type *;
+      using reference = const value_type &;
+      using iterator_concept = std::conditional_t<
+        is_random_access_iterator_v<InputIt>, std::random_access_iterator_tag, typename iterator_traversal_<InputIt>::type
+      >;
+      using iterator_category = std::input_iterator_tag;
+      using it_ops_<iterator, difference_type>::operator++;
+      using it_ops_<iterator, difference_type>::operator--;
+
+      constexpr bool operator==(const iterator &other) const noexcept {
+        return curr_ == other.curr_ && that_ == other.that_;
+      }
+
+      constexpr iterator &operator++() noexcept {
+        ++curr_;
+        cached_ = false;
+        return *this;
+      }
+
+      constexpr const value_type &operator*() const noexcept {
+        if (!cached_) {
+          value_ = that_->fn_(*curr_);
+          cached_ = true;
+        }
+        return value_;
+      }
+
+      constexpr const value_type *operator->() const noexcept {
+        return &**this;
+      }
+
+      // the following are only usable if the source iterator supports them.
+
+      constexpr iterator &operator--() noexcept {
+        --curr_;
+        cached_ = false;
+        return *this;
+      }
+
+      constexpr iterator &operator+=(difference_type n) noexcept {
+        curr_ += n;
+        cached_ = false;
+        return *this;
+      }
+
+      constexpr difference_type operator-(const iterator &other) const noexcept {
+        return curr_ - other.curr_;
+      }
+
+      using it_ops_<iterator, difference_type>::operator-;
+
+      constexpr value_type operator[](difference_type n) const noexcept {
+        return that_->fn_(curr_[n]);
+      }
+
+    private:
+      constexpr iterator(it_transform_cached *that, InputIt begin) noexcept : that_(that), curr_(begin) {}
+      friend class it_transform_cached;
+      it_transform_cached *that_;
+      InputIt curr_;
+      mutable value_type value_ {};
+      mutable bool cached_ = false;
+    };
+
+    constexpr iterator begin() noexcept {
+      return iterator(this, begin_);
+    }
+    constexpr iterator end() noexcept {
+      return iterator(this, end_);
+    }
+
+  private:
+    friend class iterator;
+    InputIt begin_, end_;
+    Fn fn_;
+  };
+
+  template<class InputIt, class Fn>
+  it_transform_cached(InputIt, InputIt, Fn) -> it_transform_cached<InputIt, Fn>;
 }  // namespace troll
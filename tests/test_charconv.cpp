@@ -0,0 +1,62 @@
+/**
+ * -- troll --
+ * 
+ * Copyright (c) 2023 dearoneesama
+ * 
+ * This software is licensed under MIT License.
+ */
+
+// built into its own executable with TROLL_STD_CHARCONV defined, since the definition must be
+// the same in every file
+#if !defined(TROLL_STD_CHARCONV)
+#define TROLL_STD_CHARCONV
+#endif
+
+#include <catch2/catch_test_macros.hpp>
+#include <etl/string_view.h>
+
+#include <troll_util/format_scan.hpp>
+
+TEST_CASE("std charconv formatting", "[format]") {
+  REQUIRE(troll::sformat<80>("{} {} {} {}", 0, -2147483647 - 1, 18446744073709551615ull, short(-7)) == "0 -2147483648 18446744073709551615 -7");
+  REQUIRE(troll::sformat<50>("{} {}", 1.5, -0.25f) == "1.500000 -0.250000");
+  std::string s = "str";
+  std::string_view sv = "view";
+  REQUIRE(troll::sformat<50>("{} and {}!", s, sv) == "str and view!");
+  REQUIRE(troll::sformat<50>("{}", troll::join(std::string_view("ab"), "")) == "ab");
+
+  // numbers that do not fit keep their leading digits
+  char buf[10];
+  REQUIRE(troll::snformat(buf, "abcde{}", 12345678) == 9);
+  REQUIRE(etl::string_view{buf} == "abcde1234");
+}
+
+TEST_CASE("std charconv scanning", "[sscan]") {
+  int i = 0;
+  unsigned u = 0;
+  int8_t small = 0;
+  REQUIRE(troll::sscan("-42,17", "{},{}", i, u));
+  REQUIRE(i == -42);
+  REQUIRE(u == 17);
+  REQUIRE(!troll::sscan("-1", "{}", u));
+  REQUIRE(!troll::sscan("128", "{}", small));
+  REQUIRE(troll::sscan("-128", "{}", small));
+  REQUIRE(small == -128);
+  REQUIRE(!troll::sscan("+1", "{}", i));
+
+  std::string word;
+  std::string_view rest;
+  REQUIRE(troll::sscan("hello brave world", "{} {} world", word, rest));
+  REQUIRE(word == "hello");
+  REQUIRE(rest == "brave");
+
+  long double ld = 0;
+  REQUIRE(troll::sscan("2.5,3", "{},{}", ld, i));
+  REQUIRE(ld == 2.5L);
+  REQUIRE(i == 3);
+
+  static constexpr troll::sscan_pattern pat{"{}:{}"};
+  REQUIRE(troll::sscan("7:x", pat, i, word));
+  REQUIRE(i == 7);
+  REQUIRE(word == "x");
+}
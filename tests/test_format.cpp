@@ -8,6 +8,8 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <etl/string_view.h>
+#include <etl/vector.h>
+#include <forward_list>
 
 #include <troll_util/format.hpp>
 #include <troll_util/utils.hpp>
@@ -71,12 +73,56 @@ TEST_CASE("sformat usage", "[format]") {
     REQUIRE(troll::sformat<50>("{}, {} done", td, td) == "td(x=90, c=c), td(x=90, c=c) done");
 
     long arrl[2];
-    int arri[2];
+    int arri[2] {};
     REQUIRE(troll::sformat<50>("p {}", arrl) == "p long array");
-    REQUIRE(troll::sformat<50>("p {}", arri) != "p long array");
+    REQUIRE(troll::sformat<50>("p {}", arri) == "p 0, 0");
   }
 }
 
+TEST_CASE("range formatting", "[format]") {
+  int arr[] {1, 2, 3};
+  etl::vector<int, 5> v {4, 5};
+  REQUIRE(troll::sformat<50>("[{}] [{}]", arr, v) == "[1, 2, 3] [4, 5]");
+  REQUIRE(troll::sformat<50>("{}|{}", troll::join(v, "-"), troll::join(arr + 1, arr + 3, "")) == "4-5|23");
+  v.clear();
+  REQUIRE(troll::sformat<50>("[{}]{}", v, 6) == "[]6");
+
+  SECTION("nested and custom elements") {
+    etl::vector<int, 2> rows[] {{1, 2}, {3}};
+    REQUIRE(troll::sformat<50>("{}", troll::join(rows, "; ")) == "1, 2; 3");
+    test_type tds[] {{1, 'a'}, {2, 'b'}};
+    REQUIRE(troll::sformat<50>("{}", tds) == "td(x=1, c=a), td(x=2, c=b)");
+    const char *strs[] {"ab", "cd"};
+    REQUIRE(troll::sformat<50>("{}", troll::join(strs, " ")) == "ab cd");
+  }
+
+  SECTION("no overflow") {
+    char s[11];
+    s[10] = 'A';
+    int many[] {100, 200, 300};
+    REQUIRE(troll::snformat(s, 10, "{} end", many) == 9);
+    REQUIRE(etl::string_view{s} == "100, 200,");
+    REQUIRE(s[10] == 'A');
+    REQUIRE(troll::snformat(s, 10, "x{}", troll::join(many, "...")) == 9);
+    REQUIRE(etl::string_view{s} == "x100...00");  // same as numbers that do not fit
+  }
+}
+
+TEST_CASE("fixed point formatting", "[format]") {
+  REQUIRE(troll::sformat<50>("{} m", troll::decimal<3>{1234}) == "1.234 m");
+  REQUIRE(troll::sformat<50>("{} {}", troll::decimal<3>{-5}, troll::decimal<3>{0}) == "-0.005 0.000");
+  REQUIRE(troll::sformat<50>("{}", troll::decimal<3, 1>{1250}) == "1.3");
+  REQUIRE(troll::sformat<50>("{}", troll::decimal<3, 1>{-1250}) == "-1.3");
+  REQUIRE(troll::sformat<50>("{}", troll::decimal<3, 2>{9999}) == "10.00");
+  REQUIRE(troll::sformat<50>("{}", troll::decimal<3, 2>{-4}) == "0.00");
+  REQUIRE(troll::sformat<50>("{}", troll::decimal<3, 2, troll::fixed_rounding::truncate>{9999}) == "9.99");
+  REQUIRE(troll::sformat<50>("{}", troll::decimal<3, 0>{-2500}) == "-3");
+  REQUIRE(troll::sformat<50>("{}", troll::decimal<2, 5>{-150}) == "-1.50000");
+  REQUIRE(troll::sformat<50>("{} {}", troll::fixed<1024>{-1536}, troll::fixed<1024, 2>{1}) == "-1.5000 0.00");
+  REQUIRE(troll::sformat<50>("{}", troll::fixed<1>{INT64_MIN}) == "-9223372036854775808");
+  REQUIRE(troll::sformat<50>("{}", troll::decimal<3>{INT64_MAX}) == "9223372036854775.807");
+}
+
 TEST_CASE("pad string usage", "pad") {
   SECTION("pad left sufficient space") {
     char s[11];
@@ -179,6 +225,11 @@ TEST_CASE("tabulate usage", "[tabulate]") {
       act += "\n";
     }
     REQUIRE(act == expected);
+
+    etl::string<1000> rendered;
+    REQUIRE(tab.render_to(rendered) == act.size());
+    REQUIRE(rendered == expected);
+    REQUIRE(tab.render_size() == act.size());
   };
 
   SECTION("truncate only element") {
@@ -200,6 +251,23 @@ R"(+----------------------------+
     compare(tab, expected);
   }
 
+  SECTION("full width cells in last column") {
+    const char *titles[] = {"ab", "TooLongTitle"};
+    int data[] = {1, 1234567};
+    auto tab = troll::make_tabulate<2, 7>(
+      troll::static_ansi_style_options<troll::ansi_font::none, troll::ansi_color::blue>{},
+      troll::tabulate_title_row_args{titles, titles + 2, troll::static_ansi_style_options<troll::ansi_font::bold>{}},
+      troll::tabulate_elem_row_args{data, troll::static_ansi_style_options_none}
+    );
+    const char expected[] =
+      "\033[34m+--------------+\033[0m\n"
+      "\033[34m|\033[0m\033[1m  ab   TooLong\033[0m\033[34m|\033[0m\n"
+      "\033[34m+--------------+\033[0m\n"
+      "\033[34m|\033[0m   1   1234567\033[34m|\033[0m\n"
+      "\033[34m+--------------+\033[0m\n";
+    compare(tab, expected);
+  }
+
   SECTION("normal usage with one field and no style and no headings") {
     const char *titles[] = {"tita1", "tita2", "titb3", "titc4", "titx5", "titw6", "tita7", "titu8", "titz9", "titz10"};
     int data[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
@@ -397,6 +465,533 @@ R"(+----------------------------------------------------------------------------
   }
 }
 
+TEST_CASE("tabulate render into buffer", "[tabulate]") {
+  const char *titles[] = {"a", "b", "c"};
+  int data[] = {1, 2, 3};
+  auto tab = troll::make_tabulate<2, 3>(
+    troll::static_ansi_style_options_none,
+    troll::tabulate_title_row_args{titles, titles + 3, troll::static_ansi_style_options_none},
+    troll::tabulate_elem_row_args{data, troll::static_ansi_style_options_none}
+  );
+  const char expected[] =
+R"(+------+
+| a  b |
++------+
+| 1  2 |
++------+
+| c    |
++------+
+| 3    |
++------+
+)";
+  using style = std::decay_t<decltype(troll::static_ansi_style_options_none)>;
+  static_assert(std::is_same_v<decltype(tab), troll::tabulate<2, 3, 3, style,
+    troll::tabulate_title_row_args<const char *, const char **, style, style>, troll::tabulate_elem_row_args<const char *, int *, style, style>>>);
+  static_assert(decltype(tab)::cell_bytes == 0);
+  REQUIRE(tab.render_size() == LEN_LITERAL(expected));
+  REQUIRE(tab.render_size(0) == 9);
+
+  SECTION("exact size") {
+    char buf[sizeof expected];
+    REQUIRE(tab.render_into(buf) == LEN_LITERAL(expected));
+    REQUIRE(etl::string_view{buf} == expected);
+  }
+
+  SECTION("insufficient space keeps whole lines") {
+    char buf[sizeof expected];
+    buf[30] = 'A';
+    REQUIRE(tab.render_into(buf, 30) == 27);
+    REQUIRE(etl::string_view{buf} == "+------+\n| a  b |\n+------+\n");
+    REQUIRE(buf[30] == 'A');
+  }
+
+  SECTION("empty buffer") {
+    char buf[1] = {'A'};
+    REQUIRE(tab.render_into(buf, 0) == 0);
+    REQUIRE(buf[0] == 'A');
+  }
+
+  SECTION("sink") {
+    etl::string<sizeof expected> out;
+    size_t calls = 0;
+    REQUIRE(tab.render_to([&](const char *data, size_t len) { out.append(data, len); ++calls; }) == LEN_LITERAL(expected));
+    REQUIRE(out == expected);
+    REQUIRE(calls == 3);
+  }
+}
+
+TEST_CASE("tabulate wide cells", "[tabulate]") {
+  const char *titles[] = {"caf\xc3\xa9", "\033[1mab\033[0m", "\xe5\xae\xbd"};
+  int data[] = {1, 22, 333};
+  auto tab = troll::make_wide_tabulate<2, 4, 5, 16>(
+    troll::static_ansi_style_options_none,
+    troll::tabulate_title_row_args{"n\xc2\xba", titles, titles + 3, troll::static_ansi_style_options_none},
+    troll::tabulate_elem_row_args{"v", data, troll::static_ansi_style_options_none}
+  );
+  using style = std::decay_t<decltype(troll::static_ansi_style_options_none)>;
+  static_assert(std::is_same_v<decltype(tab), troll::wide_tabulate<2, 4, 5, 16, style,
+    troll::tabulate_title_row_args<const char *, const char **, style, style>, troll::tabulate_elem_row_args<const char *, int *, style, style>>>);
+  const char expected[] =
+    "+--------------+\n"
+    "| n\xc2\xba caf\xc3\xa9  \033[1mab\033[0m  |\n"
+    "+--------------+\n"
+    "| v    1   22  |\n"
+    "+--------------+\n"
+    "| n\xc2\xba  \xe5\xae\xbd       |\n"
+    "+--------------+\n"
+    "| v   333      |\n"
+    "+--------------+\n";
+
+  SECTION("iterate") {
+    etl::string<sizeof expected> act;
+    for (auto line : tab) {
+      act.append(line.data(), line.size()).append("\n");
+    }
+    REQUIRE(act == expected);
+  }
+
+  SECTION("render") {
+    char buf[sizeof expected + 64];
+    REQUIRE(tab.render_size() >= LEN_LITERAL(expected));
+    REQUIRE(tab.render_into(buf) == LEN_LITERAL(expected));
+    REQUIRE(etl::string_view{buf} == expected);
+  }
+
+  SECTION("sink") {
+    etl::string<sizeof expected> out;
+    REQUIRE(tab.render_to([&](const char *data, size_t len) { out.append(data, len); }) == LEN_LITERAL(expected));
+    REQUIRE(out == expected);
+  }
+
+  auto [row, col, str] = tab.patch_str<0>(2, "\xc3\xa9");
+  REQUIRE(row == 5);
+  REQUIRE(col == 5);
+  REQUIRE(str == "  \xc3\xa9  ");
+}
+
+TEST_CASE("tabulate pages", "[tabulate]") {
+  const char *titles[] = {"a", "b", "c", "d", "e"};
+  int data[] = {1, 2, 3, 4, 5};
+  auto mapped = troll::it_transform(data, data + 5, [](int i) { return i * 10; });
+  auto tab = troll::make_tabulate<2, 4>(
+    troll::static_ansi_style_options_none,
+    troll::tabulate_title_row_args{titles, titles + 5, troll::static_ansi_style_options_none},
+    troll::tabulate_elem_row_args{mapped.begin(), troll::static_ansi_style_options_none}
+  );
+  static_assert(decltype(tab)::random_access_src);
+  REQUIRE(tab.num_row_groups() == 3);
+
+  static const auto view = [](auto &&v) {
+    etl::string<1000> act;
+    for (etl::string_view sv : v) {
+      act += sv.data();
+      act += "\n";
+    }
+    return act;
+  };
+
+  const char page1[] =
+R"(+--------+
+| c   d  |
++--------+
+| 30  40 |
++--------+
+)";
+  const char page12[] =
+R"(+--------+
+| c   d  |
++--------+
+| 30  40 |
++--------+
+| e      |
++--------+
+| 50     |
++--------+
+)";
+
+  char buf[200];
+  REQUIRE(tab.render_page(buf, sizeof buf, 1, 1) == LEN_LITERAL(page1));
+  REQUIRE(etl::string_view{buf} == page1);
+  REQUIRE(view(tab.viewport(1, 1)) == page1);
+
+  REQUIRE(tab.render_page(buf, sizeof buf, 1, 5) == LEN_LITERAL(page12));
+  REQUIRE(etl::string_view{buf} == page12);
+  REQUIRE(view(tab.viewport(1, 5)) == page12);
+
+  // past the end is an empty table
+  REQUIRE(tab.render_page(buf, sizeof buf, 3, 1) == 11);
+  REQUIRE(etl::string_view{buf} == "+--------+\n");
+  REQUIRE(view(tab.viewport(3, 1)) == "+--------+\n");
+
+  // whole table
+  REQUIRE(view(tab.viewport(0, 3)) == view(tab));
+
+  SECTION("forward iterators") {
+    std::forward_list<const char *> list(titles, titles + 5);
+    auto ftab = troll::make_tabulate<2, 4>(
+      troll::static_ansi_style_options_none,
+      troll::tabulate_title_row_args{list.begin(), list.end(), troll::static_ansi_style_options_none},
+      troll::tabulate_elem_row_args{mapped.begin(), troll::static_ansi_style_options_none}
+    );
+    static_assert(!decltype(ftab)::random_access_src);
+    REQUIRE(ftab.render_page(buf, sizeof buf, 1, 5) == LEN_LITERAL(page12));
+    REQUIRE(etl::string_view{buf} == page12);
+    REQUIRE(view(ftab.viewport(1, 1)) == page1);
+  }
+}
+
+TEST_CASE("it_transform random access", "[it_transform]") {
+  int data[] = {1, 2, 3, 4};
+  auto mapped = troll::it_transform(data, data + 4, [](int i) { return i * 2; });
+  auto it = mapped.begin();
+  REQUIRE(mapped.end() - it == 4);
+  REQUIRE(it[3] == 8);
+  it += 2;
+  REQUIRE(*it == 6);
+  REQUIRE(*(it - 1) == 4);
+  REQUIRE(it < mapped.end());
+  REQUIRE(std::next(mapped.begin(), 3) == it + 1);
+
+  // returning by value makes an input iterator that keeps the operators of the source
+  using by_value = decltype(mapped)::iterator;
+  static_assert(std::is_same_v<by_value::reference, int>);
+  static_assert(std::is_same_v<by_value::iterator_category, std::input_iterator_tag>);
+  static_assert(troll::is_random_access_iterator_v<by_value>);
+
+  struct point { int x, y; };
+  point points[] = {{1, 2}, {3, 4}};
+  auto xs = troll::it_transform(points, points + 2, [](const point &p) -> const int & { return p.x; });
+  using by_ref = decltype(xs)::iterator;
+  static_assert(std::is_same_v<by_ref::reference, const int &>);
+  static_assert(std::is_same_v<by_ref::iterator_category, std::random_access_iterator_tag>);
+  REQUIRE(*std::make_reverse_iterator(xs.end()) == 3);
+  REQUIRE(&*xs.begin() == &points[0].x);
+}
+
+TEST_CASE("it_transform adaptors", "[it_transform]") {
+  int data[] = {1, 2, 3, 4, 5, 6, 7};
+  static const auto collect = [](auto &&range) {
+    etl::vector<int, 16> v;
+    for (auto &&e : range) {
+      v.push_back(e);
+    }
+    return v;
+  };
+
+  SECTION("filter") {
+    auto odd = troll::it_filter(data, data + 7, [](int i) { return i % 2; });
+    static_assert(std::is_same_v<decltype(odd.begin())::iterator_category, std::bidirectional_iterator_tag>);
+    REQUIRE(collect(odd) == etl::vector<int, 16>{1, 3, 5, 7});
+    auto it = odd.end();
+    REQUIRE(*--it == 7);
+    REQUIRE(*--it == 5);
+    auto none = troll::it_filter(data, data + 7, [](int i) { return i > 10; });
+    REQUIRE(none.begin() == none.end());
+  }
+
+  SECTION("take and stride") {
+    auto first3 = troll::it_take(data, data + 7, 3);
+    REQUIRE(collect(first3) == etl::vector<int, 16>{1, 2, 3});
+    REQUIRE(first3.end() - first3.begin() == 3);
+    REQUIRE(collect(troll::it_take(data, data + 2, 3)) == etl::vector<int, 16>{1, 2});
+    auto every3 = troll::it_stride(data, data + 7, 3);
+    REQUIRE(collect(every3) == etl::vector<int, 16>{1, 4, 7});
+    REQUIRE(every3.end() - every3.begin() == 3);
+    REQUIRE(every3.begin()[1] == 4);
+
+    // forward-only sources are stepped through
+    std::forward_list<int> list(data, data + 7);
+    auto odd = troll::it_filter(list.begin(), list.end(), [](int i) { return i % 2; });
+    auto taken = troll::it_take(odd.begin(), odd.end(), 3);
+    static_assert(std::is_same_v<decltype(taken.begin())::iterator_category, std::forward_iterator_tag>);
+    REQUIRE(collect(taken) == etl::vector<int, 16>{1, 3, 5});
+    // the end is reached by the count or by the end of the source, whichever comes first
+    auto short_take = troll::it_take(list.begin(), list.end(), 10);
+    REQUIRE(std::distance(short_take.begin(), short_take.end()) == 7);
+    auto it = short_take.begin();
+    auto copy = it;
+    ++it;
+    REQUIRE(it != copy);
+    REQUIRE(it == std::next(copy));
+    auto empty = troll::it_take(list.end(), list.end(), 2);
+    REQUIRE(empty.begin() == empty.end());
+    REQUIRE(collect(troll::it_stride(list.begin(), list.end(), 4)) == etl::vector<int, 16>{1, 5});
+  }
+
+  SECTION("zip and chunk") {
+    const char *names[] = {"a", "b", "c"};
+    auto zipped = troll::it_zip(names, names + 3, data);
+    using zip_it = decltype(zipped.begin());
+    static_assert(std::is_same_v<zip_it::reference, decltype(*zipped.begin())>);
+    static_assert(std::is_same_v<zip_it::iterator_category, std::input_iterator_tag>);
+    static_assert(troll::is_random_access_iterator_v<zip_it>);
+    auto it = zipped.begin() + 2;
+    REQUIRE(std::get<1>(*it) == 3);
+    REQUIRE(etl::string_view{std::get<0>(*it)} == "c");
+    REQUIRE(zipped.end() - zipped.begin() == 3);
+    std::get<1>(*zipped.begin()) = 10;
+    REQUIRE(data[0] == 10);
+    data[0] = 1;
+
+    auto chunks = troll::it_chunk(data, data + 7, 3);
+    using chunk_it = decltype(chunks.begin());
+    static_assert(std::is_same_v<chunk_it::reference, decltype(*chunks.begin())>);
+    static_assert(troll::is_random_access_iterator_v<chunk_it>);
+    static_assert(!troll::is_random_access_iterator_v<decltype(troll::it_zip(names, names + 3, std::forward_list<int>{}.begin()).begin())>);
+    auto sums = troll::it_transform(chunks.begin(), chunks.end(), [](auto chunk) {
+      int sum = 0;
+      for (int i : chunk) {
+        sum += i;
+      }
+      return sum;
+    });
+    REQUIRE(collect(sums) == etl::vector<int, 16>{6, 15, 7});
+    REQUIRE(sums.end() - sums.begin() == 3);
+
+    std::forward_list<int> list(data, data + 5);
+    auto list_chunks = troll::it_chunk(list.begin(), list.end(), 2);
+    auto heads = troll::it_transform(list_chunks.begin(), list_chunks.end(), [](auto chunk) { return *chunk.begin(); });
+    REQUIRE(collect(heads) == etl::vector<int, 16>{1, 3, 5});
+  }
+
+  SECTION("cached transform") {
+    int calls = 0;
+    auto squared = troll::it_transform_cached(data, data + 7, [&calls](int i) { ++calls; return i * i; });
+    auto it = squared.begin() + 3;
+    REQUIRE(*it == 16);
+    REQUIRE(*it == 16);
+    REQUIRE(calls == 1);
+    ++it;
+    REQUIRE(*it == 25);
+    REQUIRE(calls == 2);
+
+    // the reference is into the iterator, so it does not outlive it
+    using cached_it = decltype(it);
+    static_assert(std::is_same_v<std::iterator_traits<cached_it>::iterator_category, std::input_iterator_tag>);
+    static_assert(std::is_same_v<cached_it::iterator_concept, std::random_access_iterator_tag>);
+    static_assert(troll::is_random_access_iterator_v<cached_it>);
+    REQUIRE(squared.end() - it == 3);
+    REQUIRE(it[2] == 49);
+  }
+
+  SECTION("tabulate sources") {
+    const char *titles[] = {"a", "b", "c", "d", "e", "f", "g"};
+    auto picked_titles = troll::it_stride(titles, titles + 7, 2);
+    auto picked = troll::it_stride(data, data + 7, 2);
+    auto tab = troll::make_tabulate<2, 4>(
+      troll::static_ansi_style_options_none,
+      troll::tabulate_title_row_args{picked_titles.begin(), picked_titles.end(), troll::static_ansi_style_options_none},
+      troll::tabulate_elem_row_args{picked.begin(), troll::static_ansi_style_options_none}
+    );
+    static_assert(decltype(tab)::random_access_src);
+    REQUIRE(tab.num_row_groups() == 2);
+    etl::string<200> act;
+    for (etl::string_view sv : tab) {
+      act += sv.data();
+      act += "\n";
+    }
+    REQUIRE(act ==
+R"(+--------+
+| a   c  |
++--------+
+| 1   3  |
++--------+
+| e   g  |
++--------+
+| 5   7  |
++--------+
+)");
+  }
+}
+
+TEST_CASE("styled literals", "[ansi]") {
+  using style = troll::static_ansi_style_options<troll::ansi_font::bold | troll::ansi_font::underline, troll::ansi_color::red>;
+  static constexpr auto label = troll::styled<style>("Tasks");
+  static_assert(label.size() == 5 + style::wrapper_str_size);
+  static_assert(label.data[0] == '\033' && label.data[label.size()] == '\0');
+  REQUIRE(etl::string_view{label} == "\033[1;4;31mTasks\033[0m");
+  REQUIRE(style::enabler_str() == "\033[1;4;31m");
+
+  static constexpr auto plain = troll::styled<troll::static_ansi_style_options_none_t>("key");
+  static_assert(plain.size() == 3);
+  REQUIRE(etl::string_view{plain.c_str()} == "key");
+}
+
+TEST_CASE("display width padding", "[pad]") {
+  REQUIRE(troll::is_plain_text("plain text, long enough for blocks", 34));
+  REQUIRE(!troll::is_plain_text("plain text, long enough \033[1m", 28));
+  REQUIRE(!troll::is_plain_text("caf\xc3\xa9", 5));
+
+  REQUIRE(troll::display_width("abc", 3) == 3);
+  REQUIRE(troll::display_width("\033[1;31mred\033[0m", 14) == 3);
+  REQUIRE(troll::display_width("caf\xc3\xa9", 5) == 4);
+  REQUIRE(troll::display_width("e\xcc\x81", 3) == 1);
+  REQUIRE(troll::display_width("\xe5\xae\xbd\xe5\xad\x97", 6) == 4);
+  REQUIRE(troll::display_width("\xf0\x9f\x98\x80", 4) == 2);
+  REQUIRE(troll::display_width("\xff" "a", 2) == 2);
+  static_assert(troll::display_width("\033[1mab", 6) == 2);
+
+  char buf[32] {};
+  size_t n = troll::pad_display(buf, sizeof buf, 6, "ab", 2, troll::padding::right);
+  REQUIRE(etl::string_view(buf, n) == "    ab");
+  n = troll::pad_display(buf, sizeof buf, 6, "\033[1mab\033[0m", 10, troll::padding::middle, '-');
+  REQUIRE(etl::string_view(buf, n) == "--\033[1mab\033[0m--");
+  n = troll::pad_display(buf, sizeof buf, 5, "\xe5\xae\xbd\xe5\xad\x97", 6, troll::padding::left);
+  REQUIRE(etl::string_view(buf, n) == "\xe5\xae\xbd\xe5\xad\x97 ");
+  // the wide character does not fit, but the style is still ended
+  n = troll::pad_display(buf, sizeof buf, 3, "\033[1mab\xe5\xae\xbd" "c\033[0m", 15, troll::padding::right);
+  REQUIRE(etl::string_view(buf, n) == " \033[1mab\033[0m");
+  n = troll::pad_display(buf, sizeof buf, 3, "abcdef", 6, troll::padding::left);
+  REQUIRE(etl::string_view(buf, n) == "abc");
+  // a character past the end of the buffer is not skipped over by the ones after it
+  n = troll::pad_display(buf, 3, 4, "a\xe5\xae\xbd" "b", 5, troll::padding::left);
+  REQUIRE(etl::string_view(buf, n) == "a  ");
+  n = troll::pad_display(buf, 8, 6, "\033[1ma\xf0\x9f\x98\x80" "b\033[m", 13, troll::padding::left);
+  REQUIRE(etl::string_view(buf, n) == "\033[1ma\033[m");
+
+  etl::string<16> str;
+  troll::pad_display(str, 4, "\xc3\xa9t\xc3\xa9", troll::padding::left, '.');
+  REQUIRE(str == "\xc3\xa9t\xc3\xa9.");
+}
+
+TEST_CASE("format_builder", "[format_builder]") {
+  SECTION("char buffer") {
+    char buf[16];
+    troll::format_builder b{buf};
+    b.append("x={}", 12).append(", ").append_padded(5, troll::padding::right, "{}", "ab");
+    REQUIRE(b.view() == "x=12,    ab");
+    REQUIRE(etl::string_view{buf} == "x=12,    ab");
+    REQUIRE(!b.truncated());
+    b.append("!!!");
+    REQUIRE(b.size() == 14);
+    REQUIRE(!b.truncated());
+    // the buffer holds as many characters as snformat would put in it
+    b.append("?");
+    REQUIRE(b.size() == 15);
+    REQUIRE(!b.truncated());
+    b.append("?");
+    REQUIRE(b.size() == 15);
+    REQUIRE(b.truncated());
+    b.clear();
+    REQUIRE(b.view() == "");
+    b.append_padded(3, troll::padding::middle, '-', "{}", 7).append_padded(2, troll::padding::left, "{}", "long");
+    REQUIRE(b.view() == "-7-lo");
+    REQUIRE(!b.truncated());
+    b.append_padded(20, troll::padding::left, "x");
+    REQUIRE(b.size() == 15);
+    REQUIRE(b.view() == "-7-lox         ");
+    REQUIRE(b.truncated());
+  }
+
+  SECTION("exact fits") {
+    char buf[6];
+    troll::format_builder b{buf};
+    b.append("{}-{}", 12, "ab");
+    b.append("{}", "");
+    b.append("");
+    REQUIRE(b.view() == "12-ab");
+    REQUIRE(!b.truncated());
+    b.append("{}", 'x');
+    REQUIRE(b.view() == "12-ab");
+    REQUIRE(b.truncated());
+
+    int nums[] = {1, 2};
+    b.clear();
+    b.append("{}!", nums);
+    REQUIRE(b.view() == "1, 2!");
+    REQUIRE(!b.truncated());
+    b.clear();
+    b.append("{}", troll::join(nums, "--"));
+    REQUIRE(b.view() == "1--2");
+    b.append("{}", 3);
+    REQUIRE(!b.truncated());
+    b.clear();
+    b.append("{} {}", 123, 45);
+    REQUIRE(b.size() == 5);
+    REQUIRE(b.truncated());
+  }
+
+  SECTION("styles") {
+    using style = troll::static_ansi_style_options<troll::ansi_font::bold>;
+    char buf[24];
+    troll::format_builder b{buf};
+    b.append_styled<style>("{}", "hi").append_styled<troll::static_ansi_style_options_none_t>("!");
+    REQUIRE(b.view() == "\033[1mhi\033[0m!");
+    b.append_styled<style>("{}", "cut off");
+    REQUIRE(b.view() == "\033[1mhi\033[0m!\033[1mcut \033[0m");
+    REQUIRE(b.truncated());
+    b.clear();
+    b.append("0123456789abcdefghij").append_styled<style>("x");
+    REQUIRE(b.view() == "0123456789abcdefghij");
+    REQUIRE(b.truncated());
+  }
+
+  SECTION("etl string") {
+    etl::string<10> str = "ab";
+    troll::format_builder b{str};
+    b.append("{}{}", 1, 2);
+    REQUIRE(str == "ab12");
+    b.append("{}", "345678");
+    // the whole capacity is used
+    REQUIRE(str == "ab12345678");
+    REQUIRE(!b.truncated());
+    b.append("");
+    REQUIRE(!b.truncated());
+    b.append("x");
+    REQUIRE(str == "ab12345678");
+    REQUIRE(b.truncated());
+    b.clear();
+    REQUIRE(str.empty());
+    b.append("01").append_styled<troll::static_ansi_style_options<troll::ansi_font::bold>>("{}", "ab");
+    REQUIRE(str == "01\033[1m\033[0m");
+    REQUIRE(b.truncated());
+
+    // a full string is left as it is
+    etl::string<5> full = "abcde";
+    troll::format_builder f{full};
+    REQUIRE(full == "abcde");
+    REQUIRE(!f.truncated());
+    f.append("x");
+    REQUIRE(full == "abcde");
+    REQUIRE(f.truncated());
+
+    // a first piece can fill an empty string exactly
+    etl::string<3> small;
+    troll::format_builder s{small};
+    s.append("ab");
+    REQUIRE(!s.truncated());
+    s.append("cd");
+    REQUIRE(small == "abc");
+    REQUIRE(s.truncated());
+    s.clear();
+    s.append("abc");
+    REQUIRE(small == "abc");
+    REQUIRE(!s.truncated());
+    s.clear();
+    s.append("{}", 123);
+    REQUIRE(small == "123");
+    REQUIRE(!s.truncated());
+    s.clear();
+    s.append("{}", 1234);
+    REQUIRE(s.truncated());
+  }
+
+  SECTION("tiny buffers") {
+    char one[1] = {'x'};
+    troll::format_builder b{one, 1};
+    REQUIRE(one[0] == '\0');
+    b.append("a").append_padded(2, troll::padding::left, "b").append_styled<troll::static_ansi_style_options_none_t>("c");
+    REQUIRE(b.size() == 0);
+    REQUIRE(b.truncated());
+    b.clear();
+    REQUIRE(!b.truncated());
+    troll::format_builder none{nullptr, 0};
+    none.append("a");
+    REQUIRE(none.view().empty());
+    REQUIRE(none.truncated());
+  }
+}
+
 TEST_CASE("output control usage", "[output_control]") {
   troll::output_control<20, 5> oc;
   REQUIRE(oc.enqueue(0, 5, "content") == 7);
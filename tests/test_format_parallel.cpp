@@ -0,0 +1,90 @@
+/**
+ * -- troll --
+ * 
+ * Copyright (c) 2023 dearoneesama
+ * 
+ * This software is licensed under MIT License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <etl/string_view.h>
+#include <forward_list>
+
+#include <troll_util/format_parallel.hpp>
+#include <troll_util/utils.hpp>
+
+TEST_CASE("tabulate parallel render", "[tabulate]") {
+  static int titles[1000], data[1000], data2[1000];
+  for (int i = 0; i < 1000; ++i) {
+    titles[i] = i;
+    data[i] = i * 7;
+    data2[i] = -i;
+  }
+  static char serial[200000], parallel[200000];
+
+  SECTION("random access sources") {
+    auto tab = troll::make_tabulate<7, 8, 6>(
+      troll::static_ansi_style_options<troll::ansi_font::none, troll::ansi_color::blue>{},
+      troll::tabulate_title_row_args{"idx", titles, titles + 999, troll::static_ansi_style_options<troll::ansi_font::bold>{}},
+      troll::tabulate_elem_row_args{"x7", data, troll::static_ansi_style_options_none},
+      troll::tabulate_elem_row_args{"neg", data2, troll::static_ansi_style_options<troll::ansi_font::none, troll::ansi_color::red>{}}
+    );
+    static_assert(decltype(tab)::random_access_src);
+    auto sz = tab.render_into(serial);
+    REQUIRE(sz == tab.render_size());
+    for (size_t threads : {2, 3, 8, 1000}) {
+      parallel[0] = '\0';
+      REQUIRE(troll::render_into_parallel(tab, parallel, sizeof parallel, threads) == sz);
+      REQUIRE(etl::string_view{parallel} == etl::string_view{serial});
+    }
+
+    // too small a buffer behaves as serial rendering
+    REQUIRE(troll::render_into_parallel(tab, parallel, 500, 4) == tab.render_into(serial, 500));
+    REQUIRE(etl::string_view{parallel} == etl::string_view{serial});
+  }
+
+  SECTION("it_transform sources") {
+    auto mapped = troll::it_transform(data, data + 1000, [](int i) { return i + 1; });
+    auto tab = troll::make_tabulate<10, 6>(
+      troll::static_ansi_style_options_none,
+      troll::tabulate_title_row_args{titles, titles + 1000, troll::static_ansi_style_options_none},
+      troll::tabulate_elem_row_args{mapped.begin(), troll::static_ansi_style_options_none}
+    );
+    static_assert(decltype(tab)::random_access_src);
+    auto sz = tab.render_into(serial);
+    REQUIRE(troll::render_into_parallel(tab, parallel, sizeof parallel, 4) == sz);
+    REQUIRE(etl::string_view{parallel} == etl::string_view{serial});
+  }
+
+  SECTION("fallback for wide cells") {
+    static const char *names[] = {"caf\xc3\xa9", "\033[1mab\033[0m", "\xe5\xae\xbd", "x"};
+    static const char *texts[1000];
+    for (int i = 0; i < 1000; ++i) {
+      texts[i] = names[i % 4];
+    }
+    auto tab = troll::make_wide_tabulate<7, 6, 16>(
+      troll::static_ansi_style_options_none,
+      troll::tabulate_title_row_args{texts, texts + 999, troll::static_ansi_style_options_none},
+      troll::tabulate_elem_row_args{data, troll::static_ansi_style_options_none}
+    );
+    static_assert(decltype(tab)::random_access_src);
+    auto sz = tab.render_into(serial);
+    REQUIRE(sz < tab.render_size());
+    parallel[0] = '\0';
+    REQUIRE(troll::render_into_parallel(tab, parallel, sizeof parallel, 4) == sz);
+    REQUIRE(etl::string_view{parallel} == etl::string_view{serial});
+  }
+
+  SECTION("fallback for forward iterators") {
+    std::forward_list<int> list(data, data + 1000);
+    auto tab = troll::make_tabulate<10, 6>(
+      troll::static_ansi_style_options_none,
+      troll::tabulate_title_row_args{list.begin(), list.end(), troll::static_ansi_style_options_none},
+      troll::tabulate_elem_row_args{titles, troll::static_ansi_style_options_none}
+    );
+    static_assert(!decltype(tab)::random_access_src);
+    auto sz = tab.render_into(serial);
+    REQUIRE(troll::render_into_parallel(tab, parallel, sizeof parallel, 4) == sz);
+    REQUIRE(etl::string_view{parallel} == etl::string_view{serial});
+  }
+}
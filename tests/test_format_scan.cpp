@@ -6,10 +6,14 @@
  * This software is licensed under MIT License.
  */
 
+#include <cmath>
+#include <cstring>
+#include <string_view>
 #include <catch2/catch_test_macros.hpp>
 #include <etl/string_view.h>
 
 #include <troll_util/format_scan.hpp>
+#include <troll_util/utils.hpp>
 
 namespace {
   struct test_type {
@@ -26,6 +30,41 @@ struct troll::from_stringer<test_type> {
   }
 };
 
+// scans with both the format string and the compiled pattern, which must agree
+template<size_t N, class ...Args>
+static bool sscan_both(etl::string_view test, const char (&format)[N], Args &...args) {
+  bool plain = troll::sscan(test, format, args...);
+  bool compiled = troll::sscan(test, troll::sscan_pattern{format}, args...);
+  REQUIRE(plain == compiled);
+  REQUIRE(troll::sscan_prefix(test, format, args...) == troll::sscan_prefix(test, troll::sscan_pattern{format}, args...));
+  return compiled;
+}
+
+TEST_CASE("eat_while built-in classes", "[sscan]") {
+  // long enough to go through every block size
+  const char digits[] = "0123456789012345678901234567890123456789012345678901234567890123456789x";
+  const char spaces[] = " \t\r\n \t\r\n \t\r\n \t\r\n \t\r\n \t\r\n \t\r\n \t\r\n \t\r\n \t\r\n \t\r\n \t\r\n \t\r\n\v";
+  const char words[] = "abcdefghijklmnopqrstuvwxyz~!@#$%^&*()_+\x80\xff" "0123456789abcdefghijklmnopqrstuvwxyz end";
+  for (size_t len = 0; len < sizeof digits; ++len) {
+    size_t expected = len < LEN_LITERAL(digits) - 1 ? len : LEN_LITERAL(digits) - 1;
+    REQUIRE(troll::eat_while(digits, len, troll::is_digit) == expected);
+  }
+  for (size_t len = 0; len < sizeof spaces; ++len) {
+    size_t expected = len < LEN_LITERAL(spaces) - 1 ? len : LEN_LITERAL(spaces) - 1;
+    REQUIRE(troll::eat_while(spaces, len, troll::is_white_space) == expected);
+  }
+  for (size_t len = 0; len < sizeof words; ++len) {
+    size_t expected = len < LEN_LITERAL(words) - 4 ? len : LEN_LITERAL(words) - 4;
+    REQUIRE(troll::eat_while(words, len, troll::is_non_white_space) == expected);
+  }
+  // stops at nul
+  const char with_nul[] = "abcdefghijklmnopqrstuvwxyz\0abcdefghijklmnopqrstuvwxyz";
+  REQUIRE(troll::eat_while(with_nul, sizeof with_nul, troll::is_non_white_space) == 26);
+  // unbounded
+  REQUIRE(troll::eat_while(digits, -1, troll::is_digit) == LEN_LITERAL(digits) - 1);
+  static_assert(troll::eat_while("  \t x", -1, troll::is_white_space) == 4);
+}
+
 TEST_CASE("sscan usage", "[sscan]") {
   REQUIRE(troll::sscan("abcde", "abcde"));
   REQUIRE(!troll::sscan("xbcde", "abcde"));
@@ -122,4 +161,599 @@ TEST_CASE("sscan usage", "[sscan]") {
 
     REQUIRE(troll::sscan("start td( x=16, s=abcde ) td( x=-9, s=96A ) done", "start {} {} done", td1, td2));
   }
+
+  SECTION("char followed by more input") {
+    int i = 0;
+    char c = 0;
+    REQUIRE(troll::sscan("set 16 S!", "set {} {}!", i, c));
+    REQUIRE(i == 16);
+    REQUIRE(c == 'S');
+  }
+}
+
+TEST_CASE("sscan integers", "[sscan]") {
+  int8_t i8 = 0;
+  REQUIRE(troll::sscan("127", "{}", i8));
+  REQUIRE(i8 == 127);
+  REQUIRE(troll::sscan("-128", "{}", i8));
+  REQUIRE(i8 == -128);
+  REQUIRE(!troll::sscan("128", "{}", i8));
+  REQUIRE(!troll::sscan("-129", "{}", i8));
+  REQUIRE(!troll::sscan("1000", "{}", i8));
+
+  uint16_t u16 = 0;
+  REQUIRE(troll::sscan("65535", "{}", u16));
+  REQUIRE(u16 == 65535);
+  REQUIRE(!troll::sscan("65536", "{}", u16));
+  REQUIRE(!troll::sscan("-1", "{}", u16));
+
+  int64_t i64 = 0;
+  REQUIRE(troll::sscan("-9223372036854775808", "{}", i64));
+  REQUIRE(i64 == INT64_MIN);
+  REQUIRE(!troll::sscan("9223372036854775808", "{}", i64));
+  uint64_t u64 = 0;
+  REQUIRE(troll::sscan("18446744073709551615", "{}", u64));
+  REQUIRE(u64 == UINT64_MAX);
+  REQUIRE(!troll::sscan("18446744073709551616", "{}", u64));
+  REQUIRE(!troll::sscan("184467440737095516150", "{}", u64));
+
+  int i = 0;
+  REQUIRE(!troll::sscan("-", "{}", i));
+  REQUIRE(!troll::sscan("- 1", "{} {}", i, i));
+  REQUIRE(troll::sscan("007x", "{}x", i));
+  REQUIRE(i == 7);
+  REQUIRE(troll::sscan_prefix("-42abc", "{}", i) == 3);
+  REQUIRE(i == -42);
+}
+
+TEST_CASE("sscan floats", "[sscan]") {
+  double d = 0;
+  REQUIRE(troll::sscan("1e23", "{}", d));
+  REQUIRE(d == 1e23);
+  // halfway between two doubles, ties to even
+  REQUIRE(troll::sscan("9007199254740993", "{}", d));
+  REQUIRE(d == 9007199254740992.0);
+  REQUIRE(troll::sscan("2.2250738585072011e-308", "{}", d));
+  REQUIRE(d == 2.2250738585072011e-308);
+  REQUIRE(troll::sscan("4.9406564584124654e-324", "{}", d));
+  REQUIRE(d == 4.9406564584124654e-324);
+  REQUIRE(troll::sscan("1.7976931348623157e308", "{}", d));
+  REQUIRE(d == 1.7976931348623157e308);
+  REQUIRE(troll::sscan("1e400", "{}", d));
+  REQUIRE(d == std::numeric_limits<double>::infinity());
+  REQUIRE(troll::sscan("-1e-400", "{}", d));
+  REQUIRE(d == 0);
+  REQUIRE(std::signbit(d));
+  // more than 19 significant digits, just above the halfway point
+  REQUIRE(troll::sscan("9007199254740993.00000000000000000000001", "{}", d));
+  REQUIRE(d == 9007199254740994.0);
+  REQUIRE(troll::sscan("-.5", "{}", d));
+  REQUIRE(d == -0.5);
+  REQUIRE(troll::sscan("+5.", "{}", d));
+  REQUIRE(d == 5);
+  REQUIRE(!troll::sscan(".", "{}", d));
+  REQUIRE(!troll::sscan("-e5", "{}", d));
+
+  float f = 0;
+  REQUIRE(troll::sscan("3.4028235e38", "{}", f));
+  REQUIRE(f == 3.4028235e38f);
+  REQUIRE(troll::sscan("1.4e-45", "{}", f));
+  REQUIRE(f == 1.4e-45f);
+  REQUIRE(troll::sscan("0.1", "{}", f));
+  REQUIRE(f == 0.1f);
+
+  // the number ends at the first character that cannot continue it
+  REQUIRE(troll::sscan("1.5,2.5e1", "{},{}", d, f));
+  REQUIRE(d == 1.5);
+  REQUIRE(f == 25.0f);
+  REQUIRE(troll::sscan("2e,", "{}e,", d));
+  REQUIRE(d == 2);
+  REQUIRE(troll::sscan_prefix("-7.25mm", "{}", d) == 5);
+  REQUIRE(d == -7.25);
+}
+
+TEST_CASE("sscan string views", "[sscan]") {
+  const char line[] = "  tr 12  fast\t";
+  ::etl::string_view cmd, speed;
+  int train = 0;
+  REQUIRE(troll::sscan(line, "{} {} {}", cmd, train, speed));
+  REQUIRE(cmd == "tr");
+  REQUIRE(cmd.data() == line + 2);
+  REQUIRE(train == 12);
+  REQUIRE(speed == "fast");
+  REQUIRE(speed.data() == line + 9);
+
+  REQUIRE(troll::sscan(::etl::string_view(line, 5), "{}", cmd));
+  REQUIRE(cmd == "tr");
+  REQUIRE(!troll::sscan("   ", "{}", cmd));
+
+  std::string_view std_cmd;
+  REQUIRE(troll::sscan_prefix("rv 1", troll::sscan_pattern{"{}"}, std_cmd) == 3);
+  REQUIRE(std_cmd == "rv");
+}
+
+TEST_CASE("sscan lists", "[sscan]") {
+  ::etl::vector<int, 8> speeds;
+  REQUIRE(troll::sscan("set speeds 1 2  -3 4 ", "set speeds {...}", speeds));
+  REQUIRE(speeds.size() == 4);
+  REQUIRE(speeds[2] == -3);
+  REQUIRE(speeds[3] == 4);
+
+  // stops at the first element that cannot be parsed, and the rest of the format goes on
+  int train = 0;
+  REQUIRE(sscan_both("tr 1 2 3 ; 24", "tr {...} ; {}", speeds, train));
+  REQUIRE(speeds.size() == 3);
+  REQUIRE(train == 24);
+  REQUIRE(!troll::sscan("set speeds x", "set speeds {...}", speeds));
+  REQUIRE(!troll::sscan("set speeds", "set speeds {...}", speeds));
+
+  // stops when the list is full
+  ::etl::vector<unsigned, 2> two;
+  REQUIRE(!troll::sscan("1 2 3", "{...}", two));
+  REQUIRE(troll::sscan("1 2 3", "{...} {}", two, train));
+  REQUIRE(two.size() == 2);
+  REQUIRE(train == 3);
+
+  int storage[4] {};
+  troll::scan_span<int> span {storage};
+  REQUIRE(troll::sscan("5 6 7", troll::sscan_pattern{"{...}"}, span));
+  REQUIRE(span.size == 3);
+  REQUIRE(span.elems.size() == 4);
+  REQUIRE(storage[2] == 7);
+  // the span is not narrowed, so it can be scanned into again
+  REQUIRE(troll::sscan("1 2 3 4", "{...}", span));
+  REQUIRE(span.size == 4);
+  REQUIRE(storage[3] == 4);
+
+  ::etl::vector<::etl::string_view, 4> words;
+  REQUIRE(troll::sscan("names: ab cd ef", "names: {...}", words));
+  REQUIRE(words.size() == 3);
+  REQUIRE(words[1] == "cd");
+
+  // without a variable, it is compared as is
+  REQUIRE(troll::sscan("a{...}", "a{...}"));
+}
+
+TEST_CASE("sscan radix integers", "[sscan]") {
+  uint32_t u = 0;
+  REQUIRE(troll::sscan_integer("1F40", 4, u, 16) == 4);
+  REQUIRE(u == 0x1f40);
+  REQUIRE(troll::sscan_integer("0x1f40z", 7, u, 16) == 6);
+  REQUIRE(u == 0x1f40);
+  REQUIRE(troll::sscan_integer("0xz", 3, u, 16) == 1);
+  REQUIRE(u == 0);
+  REQUIRE(troll::sscan_integer("0b1012", 6, u, 2) == 5);
+  REQUIRE(u == 0b101);
+  REQUIRE(troll::sscan_integer("0777", 4, u, 0) == 4);
+  REQUIRE(u == 0777);
+  REQUIRE(troll::sscan_integer("789", 3, u, 0) == 3);
+  REQUIRE(u == 789);
+  REQUIRE(troll::sscan_integer("ffffffff", 8, u, 16) == 8);
+  REQUIRE(u == 0xffffffff);
+  REQUIRE(troll::sscan_integer("100000000", 9, u, 16) == 0);
+  REQUIRE(troll::sscan_integer("g", 1, u, 16) == 0);
+  REQUIRE(troll::sscan_integer("1", 1, u, 7) == 0);
+  int8_t s8 = 0;
+  REQUIRE(troll::sscan_integer("-0x80", 5, s8, 0) == 5);
+  REQUIRE(s8 == -128);
+  REQUIRE(troll::sscan_integer("0x80", 4, s8, 0) == 0);
+
+  uint64_t addr = 0;
+  unsigned mask = 0, mode = 0;
+  int off = 0;
+  REQUIRE(sscan_both("poke 0x7ffe1F40 mask=0b1010 mode=755 off=-0x10", "poke {:x} mask={:b} mode={:o} off={:i}", addr, mask, mode, off));
+  REQUIRE(addr == 0x7ffe1f40);
+  REQUIRE(mask == 0b1010);
+  REQUIRE(mode == 0755);
+  REQUIRE(off == -16);
+  REQUIRE(!sscan_both("mask=0b102", "mask={:b}", mask));
+  REQUIRE(sscan_both("ff,10", "{:x},{}", addr, off));
+  REQUIRE(addr == 0xff);
+  REQUIRE(off == 10);
+
+  // other types ignore the base
+  ::etl::string<8> str;
+  REQUIRE(sscan_both("0x10", "{:x}", str));
+  REQUIRE(str == "0x10");
+
+  static constexpr troll::sscan_pattern reg{"r{}={:i};"};
+  troll::sscan_stream stream{reg, off, addr};
+  REQUIRE(stream.feed("r3=0") == troll::scan_status::needs_more);
+  REQUIRE(stream.feed("x") == troll::scan_status::needs_more);
+  REQUIRE(stream.feed("ff;") == troll::scan_status::matched);
+  REQUIRE(off == 3);
+  REQUIRE(addr == 0xff);
+}
+
+TEST_CASE("sscan fixed point", "[sscan]") {
+  troll::decimal<3> m {0};
+  REQUIRE(troll::sscan_fixed("-1.25x", 6, m) == 5);
+  REQUIRE(m.value == -1250);
+  REQUIRE(troll::sscan_fixed("+.5", 3, m) == 3);
+  REQUIRE(m.value == 500);
+  REQUIRE(troll::sscan_fixed("3.", 2, m) == 2);
+  REQUIRE(m.value == 3000);
+  REQUIRE(troll::sscan_fixed("0.00049", 7, m) == 7);
+  REQUIRE(m.value == 0);
+  REQUIRE(troll::sscan_fixed("0.0005", 6, m) == 6);
+  REQUIRE(m.value == 1);
+  REQUIRE(troll::sscan_fixed(".", 1, m) == 0);
+  REQUIRE(troll::sscan_fixed("-", 1, m) == 0);
+  REQUIRE(troll::sscan_fixed("9223372036854775.807", 20, m) == 20);
+  REQUIRE(m.value == INT64_MAX);
+  REQUIRE(troll::sscan_fixed("9223372036854775.808", 20, m) == 0);
+  REQUIRE(troll::sscan_fixed("-9223372036854775.808", 21, m) == 21);
+  REQUIRE(m.value == INT64_MIN);
+
+  troll::decimal<2, 2, troll::fixed_rounding::truncate> t {0};
+  REQUIRE(troll::sscan_fixed("1.999", 5, t) == 5);
+  REQUIRE(t.value == 199);
+  troll::fixed<1024> q {0};
+  REQUIRE(troll::sscan_fixed("-1.5", 4, q) == 4);
+  REQUIRE(q.value == -1536);
+
+  troll::decimal<3> x {0}, y {0};
+  REQUIRE(sscan_both("pos 1.5, -0.25 m", "pos {}, {} m", x, y));
+  REQUIRE(x.value == 1500);
+  REQUIRE(y.value == -250);
+  REQUIRE(!sscan_both("pos 1.5, - m", "pos {}, {} m", x, y));
+  REQUIRE(troll::sscan(troll::sformat<30>("{}", troll::decimal<3>{-20042}), "{}", x));
+  REQUIRE(x.value == -20042);
+
+  static constexpr troll::sscan_pattern pat{"{};"};
+  troll::sscan_stream stream{pat, x};
+  REQUIRE(stream.feed("-") == troll::scan_status::needs_more);
+  REQUIRE(stream.feed("7.") == troll::scan_status::needs_more);
+  REQUIRE(stream.feed("125;") == troll::scan_status::matched);
+  REQUIRE(x.value == -7125);
+}
+
+TEST_CASE("sscan scansets", "[sscan]") {
+  troll::scan_set ident;
+  REQUIRE(ident.parse("[A-Za-z0-9_]}") == 12);
+  REQUIRE(ident('q'));
+  REQUIRE(ident('_'));
+  REQUIRE(!ident('-'));
+  troll::scan_set not_comma;
+  REQUIRE(not_comma.parse("[^,]") == 4);
+  REQUIRE(not_comma(' '));
+  REQUIRE(not_comma('\xff'));
+  REQUIRE(!not_comma(','));
+  REQUIRE(!not_comma('\0'));
+  troll::scan_set brackets;
+  REQUIRE(brackets.parse("[]a-]") == 5);
+  REQUIRE(brackets(']'));
+  REQUIRE(brackets('-'));
+  REQUIRE(!brackets('b'));
+  REQUIRE(troll::scan_set{}.parse("[abc") == 0);
+
+  // long enough for the block scan
+  const char text[] = "The_quick_brown_fox_jumps_over_the_lazy_dog_0123456789_ABCDEFGHIJKLMN\xe9=1";
+  REQUIRE(troll::eat_while(text, sizeof(text) - 1, ident) == sizeof(text) - 4);
+  REQUIRE(troll::eat_while(text, sizeof(text) - 1, not_comma) == sizeof(text) - 1);
+
+  ::etl::string<16> key;
+  ::etl::string_view value;
+  int n = 0;
+  REQUIRE(sscan_both("speed_1=fast lane,3", "{[A-Za-z0-9_]}={[^,]},{}", key, value, n));
+  REQUIRE(key == "speed_1");
+  REQUIRE(value == "fast lane");
+  REQUIRE(n == 3);
+  REQUIRE(!sscan_both("=fast,3", "{[A-Za-z0-9_]}={[^,]},{}", key, value, n));
+
+  // other types are parsed from the start of the token
+  REQUIRE(sscan_both("12345", "{[0-2]}{}", n, key));
+  REQUIRE(n == 12);
+  REQUIRE(key == "345");
+
+  char path[8];
+  REQUIRE(sscan_both("/usr/lib/x.so:", "{[^:]}:", path));
+  REQUIRE(std::strcmp(path, "/usr/li") == 0);
+
+  // not closed, so compared as is
+  REQUIRE(sscan_both("{[ab}", "{[ab}"));
+
+  static constexpr troll::sscan_pattern csv{"{[^,]},{[^,]}"};
+  ::etl::string<16> a, b;
+  troll::sscan_stream stream{csv, a, b};
+  REQUIRE(stream.feed("hello wo") == troll::scan_status::needs_more);
+  REQUIRE(stream.feed("rld,x y") == troll::scan_status::needs_more);
+  REQUIRE(a == "hello world");
+  REQUIRE(stream.finish() == troll::scan_status::matched);
+  REQUIRE(b == "x y");
+}
+
+TEST_CASE("sscan compiled scansets", "[sscan]") {
+  static constexpr auto csv = troll::make_sscan_pattern([] { return "{[^,]},{[a-z]}"; });
+  static_assert(std::is_same_v<std::decay_t<decltype(csv)>, troll::sscan_pattern<15, 2>>);
+  static_assert(troll::sscan_num_sets("{[^,]},{[a-z]} {} {[x]") == 2);
+  // literal patterns compile no scansets and only keep small segments
+  static_assert(sizeof(troll::sscan_pattern<16>) <= 17 + 16 * 8 + 16);
+
+  ::etl::string<16> a, b;
+  REQUIRE(troll::sscan("x y,abc", csv, a, b));
+  REQUIRE(a == "x y");
+  REQUIRE(b == "abc");
+  REQUIRE_FALSE(troll::sscan("x y,ab1", csv, a, b));
+
+  troll::sscan_stream stream{csv, a, b};
+  REQUIRE(stream.feed("hi there,q") == troll::scan_status::needs_more);
+  REQUIRE(stream.finish() == troll::scan_status::matched);
+  REQUIRE(a == "hi there");
+  REQUIRE(b == "q");
+
+  // only the first scanset is compiled, the second one is parsed when it is scanned
+  static constexpr troll::sscan_pattern<15, 1> partial{"{[^,]},{[a-z]}"};
+  REQUIRE(troll::sscan("x y,abc", partial, a, b));
+  REQUIRE(b == "abc");
+  REQUIRE_FALSE(troll::sscan("x y,ab1", partial, a, b));
+}
+
+TEST_CASE("sscan compiled pattern", "[sscan]") {
+  static constexpr troll::sscan_pattern pat{"tr {} {} end"};
+  static_assert(pat.num_placeholders() == 2);
+
+  int i = 0;
+  unsigned u = 0;
+  REQUIRE(troll::sscan("tr -12 34 end", pat, i, u));
+  REQUIRE(i == -12);
+  REQUIRE(u == 34);
+  REQUIRE(!troll::sscan("tr -12 34 ends", pat, i, u));
+  REQUIRE(troll::sscan_prefix("tr 1 2 ending", pat, i, u) == 10);
+
+  char s[5];
+  etl::string<5> es;
+  float f = 0;
+  char c = 0;
+  test_type td;
+  const char *tests[] = {
+    "abcde", "xbcde", "abcdx", "abcdef", "", " ", "ab cde", "a b c d e", "ab cde  xz ",
+    "tr 123 456", "tr 123 456after", " tr -123  456 ", "tr 123 aaaabbbcc 176 end", "tr {} 1",
+    "td( x=16, s=abcde ) and td( x=-9, s=96A )", "set 16 S!", "set16S!", "1.5 x", "{}",
+  };
+  for (const char *t : tests) {
+    sscan_both(t, "abcde");
+    sscan_both(t, "ab  cde   ");
+    sscan_both(t, " ab  cde");
+    sscan_both(t, "tr {} {}", i, u);
+    sscan_both(t, "tr {} {}", i);
+    sscan_both(t, "tr {}", i, u);
+    sscan_both(t, "tr {} {} {} end", i, s, u);
+    sscan_both(t, "tr {}{}", es, c);
+    sscan_both(t, "{} and {}", td, td);
+    sscan_both(t, "set {} {}!", i, c);
+    sscan_both(t, "{} x", f);
+    sscan_both(t, "{}");
+    sscan_both(t, "{{}}", c);
+    sscan_both(t, "");
+  }
 }
+
+TEST_CASE("scan_dispatch", "[sscan]") {
+  int called = -1, a = 0, b = 0;
+  ::etl::string_view name;
+  // captures are held by value, so there is nothing for a pointer to point to
+  auto by_pointer = [](char *) {};
+  auto by_array = [](int, char[8]) {};
+  auto by_value = [](int, ::etl::string<8>, ::etl::string_view) {};
+  static_assert(!troll::is_scan_handler_v<decltype(by_pointer)>);
+  static_assert(!troll::is_scan_handler_v<decltype(by_array)>);
+  static_assert(troll::is_scan_handler_v<decltype(by_value)>);
+  auto dispatch = troll::scan_dispatch{
+    troll::scan_case{"tr {} {}", [&](int train, int speed) { called = 0; a = train; b = speed; }},
+    troll::scan_case{"trace {}", [&](::etl::string_view what) { called = 1; name = what; }},
+    troll::scan_case{"rv {}", [&](int train) { called = 2; a = train; }},
+    troll::scan_case{"sw {} {}", [&](int sw, char dir) { called = 3; a = sw; b = dir; }},
+    troll::scan_case{"q", [&]() { called = 4; }},
+    troll::scan_case{"{}+{}", [&](int x, int y) { called = 5; a = x; b = y; }},
+    troll::scan_case{"tr{}", [&](::etl::string_view what) { called = 6; name = what; }},
+  };
+
+  REQUIRE(dispatch(" tr 58  10 "));
+  REQUIRE(called == 0);
+  REQUIRE(a == 58);
+  REQUIRE(b == 10);
+  REQUIRE(dispatch("trace sensors"));
+  REQUIRE(called == 1);
+  REQUIRE(name == "sensors");
+  REQUIRE(dispatch("t r a c e all"));
+  REQUIRE(called == 1);
+  REQUIRE(name == "all");
+  REQUIRE(dispatch("rv 24"));
+  REQUIRE(called == 2);
+  REQUIRE(a == 24);
+  REQUIRE(dispatch("sw 153 C"));
+  REQUIRE(called == 3);
+  REQUIRE(a == 153);
+  REQUIRE(b == 'C');
+  REQUIRE(dispatch("q"));
+  REQUIRE(called == 4);
+  REQUIRE(dispatch("1 + 2"));
+  REQUIRE(called == 5);
+  REQUIRE(b == 2);
+  // falls through to a later case whose prefix is shorter
+  REQUIRE(dispatch("trx"));
+  REQUIRE(called == 6);
+  REQUIRE(name == "x");
+
+  called = -1;
+  REQUIRE(!dispatch("rv"));
+  REQUIRE(!dispatch("qq"));
+  REQUIRE(!dispatch(""));
+  REQUIRE(!dispatch("sw 1"));
+  REQUIRE(called == -1);
+
+  static constexpr troll::scan_dispatch constant{
+    troll::scan_case{"go {}", [](int) {}},
+    troll::scan_case{"stop", [] {}},
+  };
+  REQUIRE(constant("go 1"));
+  REQUIRE(constant(" s t o p "));
+  REQUIRE(!constant("go"));
+}
+
+TEST_CASE("sscan_stream", "[sscan]") {
+  using troll::scan_status;
+  static constexpr troll::sscan_pattern set_speed{"tr {} {}!"};
+
+  SECTION("byte at a time") {
+    int train = 0, speed = 0;
+    troll::sscan_stream stream{set_speed, train, speed};
+    const char input[] = " tr 58  10 !";
+    for (size_t i = 0; i + 1 < sizeof(input) - 1; ++i) {
+      REQUIRE(stream.feed(input + i, 1) == scan_status::needs_more);
+    }
+    REQUIRE(stream.feed("!") == scan_status::matched);
+    REQUIRE(stream.feed(" \r\n") == scan_status::matched);
+    REQUIRE(stream.finish() == scan_status::matched);
+    REQUIRE(train == 58);
+    REQUIRE(speed == 10);
+  }
+
+  SECTION("fails early") {
+    int train = 0, speed = 0;
+    troll::sscan_stream stream{set_speed, train, speed};
+    REQUIRE(stream.feed("t") == scan_status::needs_more);
+    REQUIRE(stream.feed("x") == scan_status::failed);
+    REQUIRE(stream.feed("r 1 2!") == scan_status::failed);
+    stream.reset();
+    REQUIRE(stream.feed("tr x") == scan_status::failed);
+    stream.reset();
+    REQUIRE(stream.feed("tr 1 2!x") == scan_status::failed);
+    stream.reset();
+    REQUIRE(stream.feed("tr 1 2") == scan_status::needs_more);
+    REQUIRE(stream.finish() == scan_status::failed);
+  }
+
+  SECTION("values split across pieces") {
+    static constexpr troll::sscan_pattern pat{"{},{}:{}"};
+    double d = 0;
+    int i = 0;
+    ::etl::string<8> str;
+    troll::sscan_stream stream{pat, d, i, str};
+    REQUIRE(stream.feed("-1.") == scan_status::needs_more);
+    REQUIRE(stream.feed("5e") == scan_status::needs_more);
+    REQUIRE(stream.feed("1,-") == scan_status::needs_more);
+    REQUIRE(d == -15);
+    REQUIRE(stream.feed("4") == scan_status::needs_more);
+    REQUIRE(stream.feed(":ab") == scan_status::needs_more);
+    REQUIRE(i == -4);
+    REQUIRE(stream.feed("c") == scan_status::needs_more);
+    REQUIRE(stream.finish() == scan_status::matched);
+    REQUIRE(str == "abc");
+
+    stream.reset();
+    REQUIRE(stream.feed("2e,3:x") == scan_status::failed);
+    stream.reset();
+    REQUIRE(stream.feed("2 ,3:x\n") == scan_status::matched);
+    REQUIRE(d == 2);
+    REQUIRE(i == 3);
+  }
+
+  SECTION("long values") {
+    static constexpr troll::sscan_pattern pat{"{} {[a-z]} {}"};
+    ::etl::string<100> word, letters;
+    long long n = 0;
+    troll::sscan_stream stream{pat, word, letters, n};
+    for (int i = 0; i < 90; ++i) {
+      REQUIRE(stream.feed("w") == scan_status::needs_more);
+    }
+    REQUIRE(stream.feed(" abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz 0") == scan_status::needs_more);
+    REQUIRE(word.size() == 90);
+    REQUIRE(letters.size() == 78);
+    // a number of more than TokenLen digits does not fit in the buffer
+    REQUIRE(stream.feed("0000000000000000000000000000000000000000000000000000000000000000000012") == scan_status::failed);
+
+    auto wide = troll::make_sscan_stream<128>(pat, word, letters, n);
+    wide.feed("a b 0000000000000000000000000000000000000000000000000000000000000000000012");
+    REQUIRE(wide.finish() == scan_status::matched);
+    REQUIRE(n == 12);
+  }
+
+  SECTION("custom types") {
+    static constexpr troll::sscan_pattern pat{"{};{}"};
+    test_type td {};
+    int i = 0;
+    troll::sscan_stream stream{pat, td, i};
+    // the parser only matches once the closing parenthesis arrives
+    REQUIRE(stream.feed("td( x=5, s=") == scan_status::needs_more);
+    REQUIRE(stream.feed("abc );") == scan_status::needs_more);
+    REQUIRE(td.x == 5);
+    REQUIRE(std::strcmp(td.s, "abc") == 0);
+    REQUIRE(stream.feed("7") == scan_status::needs_more);
+    REQUIRE(stream.finish() == scan_status::matched);
+    REQUIRE(i == 7);
+
+    stream.reset();
+    REQUIRE(stream.feed("td( y=5 );7") == scan_status::needs_more);
+    REQUIRE(stream.finish() == scan_status::failed);
+  }
+
+  SECTION("same as sscan") {
+    const char *inputs[] = {"tr 1 2!", "tr1 2 !", "tr 1 2", "tr -1 2 ! ", "tr - 1 2!", "t r 1 2!", "tr 1 2!!", ""};
+    for (auto input : inputs) {
+      int a = 0, b = 0;
+      troll::sscan_stream stream{set_speed, a, b};
+      stream.feed(input, std::strlen(input));
+      REQUIRE((stream.finish() == scan_status::matched) == troll::sscan(input, set_speed, a, b));
+    }
+
+    static constexpr troll::sscan_pattern mixed{"{:i}{[a-c]}x{}"};
+    const char *more[] = {"0x1fax2.5", "0b1cx1", "0b12x1", "019ax1", "12abcx3e1", "0xax1", "7dx1", "1ax1e"};
+    for (auto input : more) {
+      int a = 0, a2 = 0;
+      char c[4] {}, c2[4] {};
+      double d = 0, d2 = 0;
+      troll::sscan_stream stream{mixed, a, c, d};
+      stream.feed(input, std::strlen(input));
+      bool matched = stream.finish() == scan_status::matched;
+      REQUIRE(matched == troll::sscan(input, mixed, a2, c2, d2));
+      if (matched) {
+        REQUIRE(a == a2);
+        REQUIRE(std::strcmp(c, c2) == 0);
+        REQUIRE(d == d2);
+      }
+    }
+  }
+}
+
+TEST_CASE("scan_iter", "[sscan]") {
+  const char payload[] = "1:10, 2:20 ,3:30,x:40";
+  size_t count = 0;
+  for (auto &[key, value] : troll::scan_iter<int, int>(payload, "{}:{}", ",")) {
+    ++count;
+    REQUIRE(value == key * 10);
+  }
+  REQUIRE(count == 3);
+
+  static constexpr troll::sscan_pattern pair{"{} = {}"};
+  auto range = troll::scan_iter<::etl::string_view, int>("a = 1 b =2 c = 3", pair);
+  auto it = range.begin();
+  REQUIRE(std::get<0>(*it) == "a");
+  auto copy = it++;
+  REQUIRE(std::get<0>(*copy) == "a");
+  REQUIRE(std::get<1>(*it) == 2);
+  REQUIRE(std::distance(range.begin(), range.end()) == 3);
+  REQUIRE(std::distance(range.begin(), range.end()) == 3);
+  REQUIRE(troll::scan_iter<int>("", "{}").begin() == troll::scan_iter<int>("", "{}").end());
+
+  SECTION("as a tabulate source") {
+    auto ids = troll::scan_iter<::etl::string_view, int>("A1 = 5 B3 = -2 C16 = 0", pair);
+    auto names = troll::it_transform(ids.begin(), ids.end(), [](const auto &t) { return std::get<0>(t); });
+    auto values = troll::it_transform(ids.begin(), ids.end(), [](const auto &t) { return std::get<1>(t); });
+    auto tab = troll::make_tabulate<3, 5>(
+      troll::static_ansi_style_options_none,
+      troll::tabulate_title_row_args{names.begin(), names.end(), troll::static_ansi_style_options_none},
+      troll::tabulate_elem_row_args{values.begin(), troll::static_ansi_style_options_none}
+    );
+    ::etl::string<256> out;
+    tab.render_to(out);
+    REQUIRE(out ==
+      "+---------------+\n"
+      "| A1   B3   C16 |\n"
+      "+---------------+\n"
+      "|  5   -2    0  |\n"
+      "+---------------+\n");
+  }
+}
+
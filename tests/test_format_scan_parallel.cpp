@@ -0,0 +1,85 @@
+/**
+ * -- troll --
+ * 
+ * Copyright (c) 2023 dearoneesama
+ * 
+ * This software is licensed under MIT License.
+ */
+
+#include <cstdio>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+
+#include <troll_util/format_scan_parallel.hpp>
+
+namespace {
+  std::string make_log(size_t lines) {
+    std::string log;
+    char line[64];
+    for (size_t i = 0; i < lines; ++i) {
+      if (i % 97 == 3) {
+        log += "garbage line\n";
+      } else {
+        std::snprintf(line, sizeof(line), "t=%zu sensor %c%zu %d\n", i, char('A' + i % 5), i % 16 + 1, int(i % 7) - 3);
+        log += line;
+      }
+    }
+    return log;
+  }
+}
+
+TEST_CASE("scan_records", "[sscan]") {
+  static constexpr troll::sscan_pattern pattern{"t={} sensor {}{} {}"};
+  using record = std::tuple<unsigned, char, int, int>;
+  std::string log = make_log(20000);
+  REQUIRE(log.size() > 4 * troll::scan_records_min_chunk);
+
+  std::vector<record> serial, parallel;
+  std::vector<size_t> serial_failed, parallel_failed;
+  auto r1 = troll::scan_records<unsigned, char, int, int>(log, pattern, std::back_inserter(serial), std::back_inserter(serial_failed), 1);
+  auto r2 = troll::scan_records<unsigned, char, int, int>(log, pattern, std::back_inserter(parallel), std::back_inserter(parallel_failed), 4);
+
+  REQUIRE(r1.ok);
+  REQUIRE(r1.matched == serial.size());
+  REQUIRE(r1.failed == serial_failed.size());
+  REQUIRE(serial.size() + serial_failed.size() == 20000);
+  REQUIRE(serial_failed.front() == 4);
+  REQUIRE(serial_failed[1] == 101);
+  REQUIRE(serial[5] == record{6, 'B', 7, 3});
+
+  REQUIRE(r2.matched == r1.matched);
+  REQUIRE(r2.failed == r1.failed);
+  REQUIRE(parallel == serial);
+  REQUIRE(parallel_failed == serial_failed);
+
+  SECTION("file") {
+    char path[] = "/tmp/troll_scan_records_XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    REQUIRE(write(fd, log.data(), log.size()) == ssize_t(log.size()));
+    close(fd);
+
+    std::vector<record> records;
+    std::vector<size_t> failed;
+    auto r3 = troll::scan_records_file<unsigned, char, int, int>(path, pattern, std::back_inserter(records), std::back_inserter(failed), 3);
+    unlink(path);
+    REQUIRE(r3.ok);
+    REQUIRE(records == serial);
+    REQUIRE(failed == serial_failed);
+
+    REQUIRE(!troll::scan_records_file<unsigned, char, int, int>("/nonexistent/troll", pattern, std::back_inserter(records), std::back_inserter(failed)).ok);
+  }
+
+  SECTION("line ends") {
+    std::vector<std::tuple<int>> records;
+    std::vector<size_t> failed;
+    static constexpr troll::sscan_pattern num{"{}"};
+    auto r = troll::scan_records<int>("1\r\n2\n\nx\n3", num, std::back_inserter(records), std::back_inserter(failed));
+    REQUIRE(r.matched == 3);
+    REQUIRE(std::get<0>(records[2]) == 3);
+    REQUIRE(failed == std::vector<size_t>{3, 4});
+  }
+}
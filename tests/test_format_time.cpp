@@ -0,0 +1,43 @@
+/**
+ * -- troll --
+ * 
+ * Copyright (c) 2023 dearoneesama
+ * 
+ * This software is licensed under MIT License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <etl/string_view.h>
+
+#include <troll_util/format_time.hpp>
+
+TEST_CASE("clock time formatting", "[format]") {
+  using namespace std::chrono_literals;
+  REQUIRE(troll::sformat<50>("[{}]", troll::clock_time_ms{0}) == "[00:00:00.000]");
+  REQUIRE(troll::sformat<50>("[{}]", troll::clock_time_ms{3723004}) == "[01:02:03.004]");
+  REQUIRE(troll::sformat<50>("{}", troll::clock_time<100, 0>{360000099}) == "1000:00:00");
+  REQUIRE(troll::sformat<50>("{}", troll::clock_time<32768, 6>{32768 * 61 + 16384}) == "00:01:01.500000");
+  REQUIRE(troll::sformat<50>("{} {}", 90061001ms, -1500ms) == "25:01:01.001 -00:00:01.500");
+  REQUIRE(troll::sformat<50>("{}", troll::utc_time_of_day(std::chrono::system_clock::time_point{86400s * 365 + 45296789ms})) == "12:34:56.789");
+
+  SECTION("no overflow") {
+    char s[8];
+    REQUIRE(troll::snformat(s, "{}", troll::clock_time_ms{3723004}) == 7);
+    REQUIRE(etl::string_view{s} == "01:02:0");
+  }
+}
+
+TEST_CASE("timestamp cache", "[format]") {
+  troll::timestamp_cache<1000> cache;
+  REQUIRE(etl::string_view{cache.render(59999)} == "00:00:59.999");
+  REQUIRE(etl::string_view{cache.render(60000)} == "00:01:00.000");
+  REQUIRE(etl::string_view{cache.render(60042)} == "00:01:00.042");
+  REQUIRE(cache.size() == 12);
+  REQUIRE(cache.view() == "00:01:00.042");
+  REQUIRE(etl::string_view{cache.render(0)} == "00:00:00.000");
+  REQUIRE(etl::string_view{cache.render(360000000)} == "100:00:00.000");
+
+  char s[50];
+  troll::snformat(s, "[{}] ready", cache.render(3601500));
+  REQUIRE(etl::string_view{s} == "[01:00:01.500] ready");
+}
@@ -0,0 +1,112 @@
+/**
+ * -- troll --
+ * 
+ * Copyright (c) 2023 dearoneesama
+ * 
+ * This software is licensed under MIT License.
+ */
+
+// built into its own executable with TROLL_INSTRUMENT defined, since the definition must be
+// the same in every file
+#if !defined(TROLL_INSTRUMENT)
+#define TROLL_INSTRUMENT
+#endif
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <etl/string_view.h>
+
+#include <troll_util/format_scan.hpp>
+
+namespace {
+  uint64_t ticks = 0;
+  uint64_t fake_clock() {
+    return ticks += 5;
+  }
+
+  template<class Table>
+  auto *find_site(const Table &table, const char *format) {
+    for (auto &site : table.sites) {
+      if (site.format == format) {
+        return &site;
+      }
+    }
+    return static_cast<decltype(&table.sites[0])>(nullptr);
+  }
+}
+
+TEST_CASE("instrument counters", "[instrument]") {
+  static_assert(troll::instrument_enabled);
+  // the counters never need libatomic
+  static_assert(__atomic_always_lock_free(sizeof(troll::instrument_counter), 0));
+  troll::instrument_reset();
+  troll::instrument_set_clock(fake_clock);
+
+  static const char fmt[] = "x={}";
+  char buf[6];
+  troll::snformat(buf, fmt, 12);
+  troll::snformat(buf, fmt, 123);
+  auto format_site = find_site(troll::instrument_format_sites(), fmt);
+  REQUIRE(format_site);
+  REQUIRE(format_site->calls == 2);
+  REQUIRE(format_site->bytes == 9);
+  REQUIRE(format_site->truncations == 1);
+  // every call took 5 ticks
+  REQUIRE(format_site->latency[2] == 2);
+
+  static const char scan_fmt[] = "v={}";
+  int v = 0;
+  REQUIRE(troll::sscan("v=1", scan_fmt, v));
+  REQUIRE(!troll::sscan("w=1", scan_fmt, v));
+  REQUIRE(troll::sscan_prefix("v=2 rest", scan_fmt, v));
+  static constexpr troll::sscan_pattern pattern{"p{}"};
+  REQUIRE(troll::sscan("p3", pattern, v));
+  auto scan_site = find_site(troll::instrument_scan_sites(), scan_fmt);
+  REQUIRE(scan_site);
+  REQUIRE(scan_site->matches == 2);
+  REQUIRE(scan_site->fails == 1);
+  auto pattern_site = find_site(troll::instrument_scan_sites(), pattern.format());
+  REQUIRE(pattern_site);
+  REQUIRE(pattern_site->matches == 1);
+
+  auto used_sites = [] {
+    size_t used = 0;
+    for (auto &site : troll::instrument_format_sites().sites) {
+      used += site.format != nullptr;
+    }
+    return used;
+  };
+  size_t used = used_sites();
+  char dump[512];
+  size_t len = troll::instrument_dump(dump);
+  REQUIRE(len == std::strlen(dump));
+  // the dump is not counted
+  REQUIRE(used_sites() == used);
+  REQUIRE(format_site->calls == 2);
+  REQUIRE(std::strstr(dump, "format \"x={}\" calls=2 bytes=9 truncations=1 latency 2:2\n"));
+  REQUIRE(std::strstr(dump, "scan \"v={}\" matches=2 fails=1 latency 2:3\n"));
+  REQUIRE(std::strstr(dump, "scan \"p{}\" matches=1 fails=0 latency 2:1\n"));
+  REQUIRE(troll::instrument_dump(dump, 8) == 7);
+
+  troll::instrument_reset();
+  REQUIRE(used_sites() == 0);
+  REQUIRE(format_site->calls == 0);
+  REQUIRE(format_site->latency[2] == 0);
+  REQUIRE(scan_site->matches == 0);
+  REQUIRE(troll::instrument_dump(dump) == 0);
+  troll::instrument_set_clock(nullptr);
+}
+
+TEST_CASE("instrument output_control", "[instrument]") {
+  troll::output_control<20, 5, 2> oc;
+  REQUIRE(oc.enqueue(0, 0, "a") == 1);
+  REQUIRE(oc.enqueue(1, 0, "bc") == 2);
+  REQUIRE(oc.enqueue(2, 0, "d") == 0);
+  REQUIRE(oc.stats().max_queue_depth == 2);
+  REQUIRE(oc.stats().drops == 1);
+  auto first = oc.dequeue();
+  auto second = oc.dequeue();
+  REQUIRE(oc.stats().dequeues == 2);
+  REQUIRE(oc.stats().dequeued_bytes == first.size() + second.size());
+  REQUIRE(oc.stats().max_dequeue_bytes == second.size());
+}